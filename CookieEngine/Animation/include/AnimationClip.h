@@ -0,0 +1,51 @@
+//
+//  AnimationClip.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_AnimationClip_h
+#define CookieEngine_AnimationClip_h
+
+#include "AlignedAllocator.h"
+#include "CookieMath.h"
+
+namespace CookieEngine
+{
+
+// Uniformly sampled local joint transforms. Keys are whole matrices, CookieMath
+// has no quaternion type, and frames are interpolated with Matrix4 Lerp. That
+// is fine at typical 30 fps sample rates but shears rotations of more than a
+// few tens of degrees between samples, so fast motion needs a higher rate.
+class AnimationClip
+{
+private:
+    uint32_t mJointCount;
+    uint32_t mFrameCount;
+    float mFrameRate;
+    AlignedVector<Matrix4> mFrames;
+    
+public:
+    AnimationClip(uint32_t jointCount, uint32_t frameCount, float frameRate);
+    
+    // Local transforms of every joint at frame
+    __attribute__((always_inline)) Matrix4* GetFrame(uint32_t frame) { return &mFrames[frame * mJointCount]; }
+    __attribute__((always_inline)) const Matrix4* GetFrame(uint32_t frame) const { return &mFrames[frame * mJointCount]; }
+    
+    __attribute__((always_inline)) uint32_t GetJointCount() const { return mJointCount; }
+    __attribute__((always_inline)) uint32_t GetFrameCount() const { return mFrameCount; }
+    
+    // Length of the clip in seconds
+    float GetDuration() const;
+    
+    // Writes the local transforms at time into locals
+    void Sample(float time, bool loop, Matrix4* locals) const;
+};
+
+// out = Lerp(a, b, f) for count joints, for cross fading between clips
+void BlendPoses(const Matrix4* a, const Matrix4* b, float f, uint32_t count, Matrix4* out);
+
+} // namespace CookieEngine
+
+#endif
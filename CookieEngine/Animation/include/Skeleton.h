@@ -0,0 +1,69 @@
+//
+//  Skeleton.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Skeleton_h
+#define CookieEngine_Skeleton_h
+
+#include "AlignedAllocator.h"
+#include "CookieMath.h"
+
+#include <string>
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+// Joint hierarchy of a skinned mesh. Joints are stored parent first, so
+// local-to-model transforms are computed in one linear pass.
+class Skeleton
+{
+private:
+    std::vector<int16_t> mParents;
+    std::vector<std::string> mNames;
+    AlignedVector<Matrix4> mBindPose;
+    AlignedVector<Matrix4> mInverseBindPose;
+    
+public:
+    static const int kNoParent = -1;
+    
+    // Adds a joint with its bind pose relative to parent. parent MUST already
+    // be in the skeleton. Returns the joint index.
+    int AddJoint(const std::string& name, int parent, const Matrix4& bindLocal);
+    
+    // Derives the inverse bind matrices from the local bind poses
+    void ComputeInverseBindPose();
+    
+    // Overrides the inverse bind matrix of joint, e.g. with the one from an asset
+    void SetInverseBindMatrix(int joint, const Matrix4& inverseBind);
+    
+    // Returns the joint called name or -1
+    int FindJoint(const std::string& name) const;
+    
+    __attribute__((always_inline)) uint32_t GetJointCount() const { return (uint32_t)mParents.size(); }
+    __attribute__((always_inline)) int GetParent(int joint) const { return mParents[joint]; }
+    __attribute__((always_inline)) const std::string& GetName(int joint) const { return mNames[joint]; }
+    __attribute__((always_inline)) const Matrix4* GetBindPose() const { return mBindPose.data(); }
+    __attribute__((always_inline)) const Matrix4* GetInverseBindPose() const { return mInverseBindPose.data(); }
+    
+    // models[i] = models[parent] * locals[i]
+    void ComputeModelTransforms(const Matrix4* locals, Matrix4* models) const;
+    
+    // Computes model transforms and the skinning palette (model * inverse bind) in one pass
+    void ComputeSkinningPalette(const Matrix4* locals, Matrix4* models, Matrix4* palette) const;
+    
+    // Computes palettes for instanceCount poses of this skeleton. Every array
+    // holds GetJointCount() matrices per instance back to back. Instances are
+    // spread over jobs if it is not nullptr.
+    void ComputeSkinningPalettes(uint32_t instanceCount, const Matrix4* locals, Matrix4* models,
+                                 Matrix4* palettes, JobSystem* jobs) const;
+};
+
+} // namespace CookieEngine
+
+#endif
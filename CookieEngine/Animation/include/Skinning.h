@@ -0,0 +1,57 @@
+//
+//  Skinning.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Skinning_h
+#define CookieEngine_Skinning_h
+
+#include "AlignedAllocator.h"
+#include "CookieMath.h"
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+static const uint32_t kMaxJointInfluences = 4;
+
+// Per vertex joint influences. Weights of a vertex should sum to 1, unused
+// influences have weight 0.
+struct SkinWeights
+{
+    uint16_t joints[kMaxJointInfluences];
+    float weights[kMaxJointInfluences];
+};
+
+// Structure of arrays vertex streams, one component per array so the
+// skinning kernel can load 4 vertices with a single instruction
+struct VertexStreams
+{
+    AlignedVector<float> positionX;
+    AlignedVector<float> positionY;
+    AlignedVector<float> positionZ;
+    AlignedVector<float> normalX;
+    AlignedVector<float> normalY;
+    AlignedVector<float> normalZ;
+    
+    // Resizes every stream to count vertices
+    void Resize(uint32_t count);
+    
+    uint32_t GetVertexCount() const { return (uint32_t)positionX.size(); }
+};
+
+// Skins vertices [begin, end) of in into out with the palette matrices.
+// Normals are transformed without the translation and are not renormalized.
+void SkinVertices(const Matrix4* palette, const VertexStreams& in, const SkinWeights* weights,
+                  VertexStreams& out, uint32_t begin, uint32_t end);
+
+// Skins all vertices, split over the job system
+void SkinVertices(const Matrix4* palette, const VertexStreams& in, const SkinWeights* weights,
+                  VertexStreams& out, JobSystem& jobs);
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,54 @@
+//
+//  AnimationClip.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "AnimationClip.h"
+
+#include <cmath>
+
+namespace CookieEngine
+{
+
+AnimationClip::AnimationClip(uint32_t jointCount, uint32_t frameCount, float frameRate)
+    : mJointCount(jointCount), mFrameCount(frameCount ? frameCount : 1), mFrameRate(frameRate),
+      mFrames((size_t)jointCount * (frameCount ? frameCount : 1), Matrix4::Identity)
+{
+}
+
+float AnimationClip::GetDuration() const
+{
+    return (mFrameCount - 1) / mFrameRate;
+}
+
+void AnimationClip::Sample(float time, bool loop, Matrix4* locals) const
+{
+    float frame = time * mFrameRate;
+    float lastFrame = (float)(mFrameCount - 1);
+    
+    if(loop && lastFrame > 0.0f)
+    {
+        frame = fmodf(frame, lastFrame);
+        frame = frame < 0.0f ? frame + lastFrame : frame;
+    }
+    else
+    {
+        frame = frame < 0.0f ? 0.0f : (frame > lastFrame ? lastFrame : frame);
+    }
+    
+    uint32_t index = (uint32_t)frame;
+    uint32_t next = index + 1 < mFrameCount ? index + 1 : index;
+    BlendPoses(GetFrame(index), GetFrame(next), frame - (float)index, mJointCount, locals);
+}
+
+void BlendPoses(const Matrix4* a, const Matrix4* b, float f, uint32_t count, Matrix4* out)
+{
+    for(uint32_t i = 0; i < count; i++)
+    {
+        out[i] = Lerp(a[i], b[i], f);
+    }
+}
+
+} // namespace CookieEngine
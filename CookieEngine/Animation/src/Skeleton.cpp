@@ -0,0 +1,104 @@
+//
+//  Skeleton.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Skeleton.h"
+#include "JobSystem.h"
+
+#include <cassert>
+
+namespace CookieEngine
+{
+
+int Skeleton::AddJoint(const std::string& name, int parent, const Matrix4& bindLocal)
+{
+    assert(parent < (int)mParents.size() && "Parents must be added before their children");
+    
+    mParents.push_back((int16_t)parent);
+    mNames.push_back(name);
+    mBindPose.push_back(bindLocal);
+    mInverseBindPose.push_back(Matrix4::Identity);
+    return (int)mParents.size() - 1;
+}
+
+void Skeleton::ComputeInverseBindPose()
+{
+    ComputeModelTransforms(mBindPose.data(), mInverseBindPose.data());
+    for(size_t i = 0; i < mInverseBindPose.size(); i++)
+    {
+        mInverseBindPose[i].Invert();
+    }
+}
+
+void Skeleton::SetInverseBindMatrix(int joint, const Matrix4& inverseBind)
+{
+    mInverseBindPose[joint] = inverseBind;
+}
+
+int Skeleton::FindJoint(const std::string& name) const
+{
+    for(size_t i = 0; i < mNames.size(); i++)
+    {
+        if(mNames[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void Skeleton::ComputeModelTransforms(const Matrix4* locals, Matrix4* models) const
+{
+    uint32_t count = GetJointCount();
+    const int16_t* parents = mParents.data();
+    
+    for(uint32_t i = 0; i < count; i++)
+    {
+        int parent = parents[i];
+        models[i] = parent == kNoParent ? locals[i] : Concatenate(models[parent], locals[i]);
+    }
+}
+
+void Skeleton::ComputeSkinningPalette(const Matrix4* locals, Matrix4* models, Matrix4* palette) const
+{
+    uint32_t count = GetJointCount();
+    const int16_t* parents = mParents.data();
+    const Matrix4* inverseBind = mInverseBindPose.data();
+    
+    for(uint32_t i = 0; i < count; i++)
+    {
+        int parent = parents[i];
+        models[i] = parent == kNoParent ? locals[i] : Concatenate(models[parent], locals[i]);
+        palette[i] = Concatenate(models[i], inverseBind[i]);
+    }
+}
+
+void Skeleton::ComputeSkinningPalettes(uint32_t instanceCount, const Matrix4* locals, Matrix4* models,
+                                       Matrix4* palettes, JobSystem* jobs) const
+{
+    uint32_t joints = GetJointCount();
+    
+    if(!jobs)
+    {
+        for(uint32_t i = 0; i < instanceCount; i++)
+        {
+            ComputeSkinningPalette(locals + i * joints, models + i * joints, palettes + i * joints);
+        }
+        return;
+    }
+    
+    // Roughly 256 joints of work per range keeps the scheduling overhead small
+    uint32_t grain = joints ? (256 + joints - 1) / joints : 1;
+    jobs->ParallelFor(instanceCount, grain, [=](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t i = begin; i < end; i++)
+        {
+            ComputeSkinningPalette(locals + i * joints, models + i * joints, palettes + i * joints);
+        }
+    });
+}
+
+} // namespace CookieEngine
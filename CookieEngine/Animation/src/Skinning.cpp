@@ -0,0 +1,130 @@
+//
+//  Skinning.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Skinning.h"
+#include "JobSystem.h"
+
+#include <smmintrin.h>
+
+namespace CookieEngine
+{
+
+// Vertices per job, a multiple of 4 so only the last range has a scalar tail
+static const uint32_t kSkinningGrainSize = 1024;
+
+void VertexStreams::Resize(uint32_t count)
+{
+    positionX.resize(count);
+    positionY.resize(count);
+    positionZ.resize(count);
+    normalX.resize(count);
+    normalY.resize(count);
+    normalZ.resize(count);
+}
+
+// Blends the top three rows of the influencing palette matrices. The bottom
+// row of an affine matrix is always (0, 0, 0, 1) and is not needed.
+__attribute__((always_inline)) static inline void BlendRows(const Matrix4* palette, const SkinWeights& skin,
+                                                            __m128& row0, __m128& row1, __m128& row2)
+{
+    __m128 weight = _mm_set_ps1(skin.weights[0]);
+    const Matrix4& m0 = palette[skin.joints[0]];
+    row0 = _mm_mul_ps(m0.GetRow(0), weight);
+    row1 = _mm_mul_ps(m0.GetRow(1), weight);
+    row2 = _mm_mul_ps(m0.GetRow(2), weight);
+    
+    for(uint32_t i = 1; i < kMaxJointInfluences; i++)
+    {
+        weight = _mm_set_ps1(skin.weights[i]);
+        const Matrix4& m = palette[skin.joints[i]];
+        row0 = _mm_add_ps(row0, _mm_mul_ps(m.GetRow(0), weight));
+        row1 = _mm_add_ps(row1, _mm_mul_ps(m.GetRow(1), weight));
+        row2 = _mm_add_ps(row2, _mm_mul_ps(m.GetRow(2), weight));
+    }
+}
+
+static void SkinVertexScalar(const Matrix4* palette, const VertexStreams& in, const SkinWeights& skin,
+                             VertexStreams& out, uint32_t i)
+{
+    __m128 row[3];
+    BlendRows(palette, skin, row[0], row[1], row[2]);
+    
+    __m128 position = _mm_setr_ps(in.positionX[i], in.positionY[i], in.positionZ[i], 1.0f);
+    __m128 normal = _mm_setr_ps(in.normalX[i], in.normalY[i], in.normalZ[i], 0.0f);
+    
+    out.positionX[i] = _mm_cvtss_f32(_mm_dp_ps(row[0], position, 0xF1));
+    out.positionY[i] = _mm_cvtss_f32(_mm_dp_ps(row[1], position, 0xF1));
+    out.positionZ[i] = _mm_cvtss_f32(_mm_dp_ps(row[2], position, 0xF1));
+    out.normalX[i] = _mm_cvtss_f32(_mm_dp_ps(row[0], normal, 0x71));
+    out.normalY[i] = _mm_cvtss_f32(_mm_dp_ps(row[1], normal, 0x71));
+    out.normalZ[i] = _mm_cvtss_f32(_mm_dp_ps(row[2], normal, 0x71));
+}
+
+void SkinVertices(const Matrix4* palette, const VertexStreams& in, const SkinWeights* weights,
+                  VertexStreams& out, uint32_t begin, uint32_t end)
+{
+    uint32_t i = begin;
+    
+    // Peel until i is 4 aligned so the stream loads below are aligned
+    for(; i < end && (i & 3); i++)
+    {
+        SkinVertexScalar(palette, in, weights[i], out, i);
+    }
+    
+    for(; i + 4 <= end; i += 4)
+    {
+        // a0..d0 are the blended first rows of vertices a..d, transposing
+        // them gives the x, y, z and w columns of that row for all 4 vertices
+        __m128 a0, a1, a2, b0, b1, b2, c0, c1, c2, d0, d1, d2;
+        BlendRows(palette, weights[i + 0], a0, a1, a2);
+        BlendRows(palette, weights[i + 1], b0, b1, b2);
+        BlendRows(palette, weights[i + 2], c0, c1, c2);
+        BlendRows(palette, weights[i + 3], d0, d1, d2);
+        
+        _MM_TRANSPOSE4_PS(a0, b0, c0, d0);
+        _MM_TRANSPOSE4_PS(a1, b1, c1, d1);
+        _MM_TRANSPOSE4_PS(a2, b2, c2, d2);
+        
+        __m128 px = _mm_load_ps(&in.positionX[i]);
+        __m128 py = _mm_load_ps(&in.positionY[i]);
+        __m128 pz = _mm_load_ps(&in.positionZ[i]);
+        __m128 nx = _mm_load_ps(&in.normalX[i]);
+        __m128 ny = _mm_load_ps(&in.normalY[i]);
+        __m128 nz = _mm_load_ps(&in.normalZ[i]);
+        
+        __m128 x = _mm_add_ps(_mm_mul_ps(a0, px), _mm_mul_ps(b0, py));
+        __m128 y = _mm_add_ps(_mm_mul_ps(a1, px), _mm_mul_ps(b1, py));
+        __m128 z = _mm_add_ps(_mm_mul_ps(a2, px), _mm_mul_ps(b2, py));
+        _mm_store_ps(&out.positionX[i], _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(c0, pz)), d0));
+        _mm_store_ps(&out.positionY[i], _mm_add_ps(_mm_add_ps(y, _mm_mul_ps(c1, pz)), d1));
+        _mm_store_ps(&out.positionZ[i], _mm_add_ps(_mm_add_ps(z, _mm_mul_ps(c2, pz)), d2));
+        
+        x = _mm_add_ps(_mm_mul_ps(a0, nx), _mm_mul_ps(b0, ny));
+        y = _mm_add_ps(_mm_mul_ps(a1, nx), _mm_mul_ps(b1, ny));
+        z = _mm_add_ps(_mm_mul_ps(a2, nx), _mm_mul_ps(b2, ny));
+        _mm_store_ps(&out.normalX[i], _mm_add_ps(x, _mm_mul_ps(c0, nz)));
+        _mm_store_ps(&out.normalY[i], _mm_add_ps(y, _mm_mul_ps(c1, nz)));
+        _mm_store_ps(&out.normalZ[i], _mm_add_ps(z, _mm_mul_ps(c2, nz)));
+    }
+    
+    for(; i < end; i++)
+    {
+        SkinVertexScalar(palette, in, weights[i], out, i);
+    }
+}
+
+void SkinVertices(const Matrix4* palette, const VertexStreams& in, const SkinWeights* weights,
+                  VertexStreams& out, JobSystem& jobs)
+{
+    uint32_t count = in.GetVertexCount();
+    jobs.ParallelFor(count, kSkinningGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        SkinVertices(palette, in, weights, out, begin, end);
+    });
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,63 @@
+//
+//  AabbSet.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_AabbSet_h
+#define CookieEngine_AabbSet_h
+
+#include "AlignedAllocator.h"
+#include "Vector3.h"
+
+namespace CookieEngine
+{
+
+// Axis aligned bounding boxes of all bodies, stored as one array per bound
+// so the broadphases can test several boxes per SSE instruction. A body's
+// index in the set is its id in the pair lists.
+class AabbSet
+{
+private:
+    AlignedVector<float> mMinX;
+    AlignedVector<float> mMinY;
+    AlignedVector<float> mMinZ;
+    AlignedVector<float> mMaxX;
+    AlignedVector<float> mMaxY;
+    AlignedVector<float> mMaxZ;
+    
+public:
+    // Appends a body and returns its id
+    uint32_t Add(const Vector3& min, const Vector3& max);
+    
+    // Updates the bounds of body id
+    __attribute__((always_inline)) void Set(uint32_t id, const Vector3& min, const Vector3& max)
+    {
+        mMinX[id] = min.GetX();
+        mMinY[id] = min.GetY();
+        mMinZ[id] = min.GetZ();
+        mMaxX[id] = max.GetX();
+        mMaxY[id] = max.GetY();
+        mMaxZ[id] = max.GetZ();
+    }
+    
+    // Grows or shrinks the set to count bodies, new bodies have empty bounds at the origin
+    void Resize(uint32_t count);
+    
+    // Removes all bodies
+    void Clear();
+    
+    __attribute__((always_inline)) uint32_t GetCount() const { return (uint32_t)mMinX.size(); }
+    
+    __attribute__((always_inline)) const float* GetMinX() const { return mMinX.data(); }
+    __attribute__((always_inline)) const float* GetMinY() const { return mMinY.data(); }
+    __attribute__((always_inline)) const float* GetMinZ() const { return mMinZ.data(); }
+    __attribute__((always_inline)) const float* GetMaxX() const { return mMaxX.data(); }
+    __attribute__((always_inline)) const float* GetMaxY() const { return mMaxY.data(); }
+    __attribute__((always_inline)) const float* GetMaxZ() const { return mMaxZ.data(); }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,41 @@
+//
+//  BroadphasePair.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_BroadphasePair_h
+#define CookieEngine_BroadphasePair_h
+
+#include <cstdint>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Two bodies whose bounds overlap, always a < b
+struct BroadphasePair
+{
+    uint32_t a;
+    uint32_t b;
+    
+    __attribute__((always_inline)) bool operator<(const BroadphasePair& rhs) const
+    {
+        return a != rhs.a ? a < rhs.a : b < rhs.b;
+    }
+    
+    __attribute__((always_inline)) bool operator==(const BroadphasePair& rhs) const
+    {
+        return a == rhs.a && b == rhs.b;
+    }
+};
+
+// Concatenates the pairs found by each job into out and sorts them. Every
+// broadphase returns its pairs in this order, so results do not depend on the
+// thread count or on which broadphase found them.
+void MergePairs(std::vector<std::vector<BroadphasePair> >& rangePairs, std::vector<BroadphasePair>& out);
+
+} // namespace CookieEngine
+
+#endif
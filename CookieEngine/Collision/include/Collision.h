@@ -0,0 +1,13 @@
+//
+//  Collision.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "AabbSet.h"
+#include "BroadphasePair.h"
+#include "SweepAndPrune.h"
+#include "SpatialHashGrid.h"
+#include "Ray.h"
+#include "TriangleBvh.h"
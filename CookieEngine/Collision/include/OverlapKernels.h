@@ -0,0 +1,104 @@
+//
+//  OverlapKernels.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_OverlapKernels_h
+#define CookieEngine_OverlapKernels_h
+
+#include "AabbSet.h"
+#include "BroadphasePair.h"
+
+#include <limits>
+#include <smmintrin.h>
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+// Boxes tested per SSE step, and the padding behind BoundsStreams so a step may run past the end
+static const uint32_t kOverlapLanes = 4;
+
+// Bounds copied into the order a broadphase walks them
+struct BoundsStreams
+{
+    AlignedVector<float> minX;
+    AlignedVector<float> minY;
+    AlignedVector<float> minZ;
+    AlignedVector<float> maxX;
+    AlignedVector<float> maxY;
+    AlignedVector<float> maxZ;
+    
+    // Resizes to count boxes plus padding boxes that overlap nothing and sort last
+    void Resize(uint32_t count)
+    {
+        float infinity = std::numeric_limits<float>::infinity();
+        minX.resize(count + kOverlapLanes);
+        minY.resize(count + kOverlapLanes);
+        minZ.resize(count + kOverlapLanes);
+        maxX.resize(count + kOverlapLanes);
+        maxY.resize(count + kOverlapLanes);
+        maxZ.resize(count + kOverlapLanes);
+        for(uint32_t i = count; i < count + kOverlapLanes; i++)
+        {
+            minX[i] = minY[i] = minZ[i] = infinity;
+            maxX[i] = maxY[i] = maxZ[i] = -infinity;
+        }
+    }
+    
+    __attribute__((always_inline)) void Copy(uint32_t to, const AabbSet& bodies, uint32_t id)
+    {
+        minX[to] = bodies.GetMinX()[id];
+        minY[to] = bodies.GetMinY()[id];
+        minZ[to] = bodies.GetMinZ()[id];
+        maxX[to] = bodies.GetMaxX()[id];
+        maxY[to] = bodies.GetMaxY()[id];
+        maxZ[to] = bodies.GetMaxZ()[id];
+    }
+};
+
+// One box broadcast to all lanes
+struct OverlapQuery
+{
+    __m128 minX;
+    __m128 minY;
+    __m128 minZ;
+    __m128 maxX;
+    __m128 maxY;
+    __m128 maxZ;
+    
+    __attribute__((always_inline)) OverlapQuery(const BoundsStreams& bounds, uint32_t i)
+        : minX(_mm_set_ps1(bounds.minX[i])), minY(_mm_set_ps1(bounds.minY[i])), minZ(_mm_set_ps1(bounds.minZ[i])),
+          maxX(_mm_set_ps1(bounds.maxX[i])), maxY(_mm_set_ps1(bounds.maxY[i])), maxZ(_mm_set_ps1(bounds.maxZ[i]))
+    {
+    }
+};
+
+// Returns a 4 bit mask of the boxes j..j+3 that overlap query on all axes. Touching boxes overlap.
+__attribute__((always_inline)) inline int TestOverlap4(const OverlapQuery& query, const BoundsStreams& bounds, uint32_t j)
+{
+    __m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&bounds.minX[j]), query.maxX),
+                                _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxX[j]), query.minX));
+    overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_loadu_ps(&bounds.minY[j]), query.maxY));
+    overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxY[j]), query.minY));
+    overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_loadu_ps(&bounds.minZ[j]), query.maxZ));
+    overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxZ[j]), query.minZ));
+    return _mm_movemask_ps(overlap);
+}
+
+// Appends the pair of bodies a and b with the smaller id first
+__attribute__((always_inline)) inline void AddPair(std::vector<BroadphasePair>& pairs, uint32_t a, uint32_t b)
+{
+    BroadphasePair pair;
+    pair.a = a < b ? a : b;
+    pair.b = a < b ? b : a;
+    pairs.push_back(pair);
+}
+
+} // namespace Detail
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,49 @@
+//
+//  Ray.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Ray_h
+#define CookieEngine_Ray_h
+
+#include "CookieMath.h"
+
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+static const uint32_t kNoHit = 0xFFFFFFFF;
+
+// Half line starting at origin. direction does not need to be normalized,
+// distances are then measured in multiples of its length.
+struct Ray
+{
+    Vector3 origin;
+    Vector3 direction;
+    float maxDistance;
+    
+    Ray() : origin(Vector3::Zero), direction(Vector3::Forward), maxDistance(1e30f) {}
+    Ray(const Vector3& o, const Vector3& d, float maxDist = 1e30f) : origin(o), direction(d), maxDistance(maxDist) {}
+} __attribute__ ((aligned (16)));
+
+// Closest intersection of a ray, triangle is kNoHit on a miss. u and v are the
+// barycentric coordinates of the hit relative to the second and third vertex.
+struct RayHit
+{
+    float distance;
+    uint32_t triangle;
+    float u;
+    float v;
+};
+
+// Returns the ray through pixel (x, y) of a width x height viewport, y
+// pointing down. It starts on the near plane and has unit length direction.
+// view and projection are the CreateLookAt and CreatePerspective matrices.
+Ray ScreenPointToRay(float x, float y, float width, float height, const Matrix4& view, const Matrix4& projection);
+
+} // namespace CookieEngine
+
+#endif
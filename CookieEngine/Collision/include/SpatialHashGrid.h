@@ -0,0 +1,84 @@
+//
+//  SpatialHashGrid.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_SpatialHashGrid_h
+#define CookieEngine_SpatialHashGrid_h
+
+#include "AabbSet.h"
+#include "BroadphasePair.h"
+#include "OverlapKernels.h"
+
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+// Uniform grid for dense scenes where many bodies share the same x range and
+// sweep and prune degrades. Every body is entered into each cell it touches,
+// entries are sorted by cell key, and bodies sharing a cell are tested 4 at a
+// time. A pair touching several common cells is only reported by the cell
+// holding the min corner of their overlap. The cell size should be about the
+// size of a typical body; bodies spanning more than kMaxCellsPerBody cells are
+// tested against everything instead.
+class SpatialHashGrid
+{
+public:
+    static const uint32_t kMaxCellsPerBody = 64;
+    
+private:
+    struct CellEntry
+    {
+        uint64_t key;
+        uint32_t body;
+    };
+    
+    // Bounds of one body packed together, gathering them into cell order then
+    // misses the cache once per entry instead of once per bound
+    struct BodyBounds
+    {
+        float min[3];
+        float max[3];
+    };
+    
+    float mCellSize;
+    float mInvCellSize;
+    std::vector<uint32_t> mEntryOffsets;    // first entry of each body, then the total
+    std::vector<CellEntry> mEntries;
+    std::vector<CellEntry> mSortScratch;
+    std::vector<BodyBounds> mBodies;
+    std::vector<uint32_t> mCellStarts;      // first entry of each occupied cell, then the total
+    std::vector<uint32_t> mLargeBodies;
+    std::vector<uint8_t> mIsLarge;
+    Detail::BoundsStreams mEntryBounds;
+    Detail::BoundsStreams mBodyBounds;
+    std::vector<std::vector<BroadphasePair> > mRangePairs;
+    
+    // Cell coordinate of position x on one axis
+    int32_t GetCell(float x) const;
+    
+    void CountEntries(const AabbSet& bodies, uint32_t begin, uint32_t end);
+    void FillEntries(const AabbSet& bodies, uint32_t begin, uint32_t end);
+    void SortEntries();
+    void TestCells(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const;
+    void TestLargeBodies(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const;
+    
+public:
+    explicit SpatialHashGrid(float cellSize);
+    
+    void SetCellSize(float cellSize);
+    __attribute__((always_inline)) float GetCellSize() const { return mCellSize; }
+    
+    // Writes every overlapping pair of bodies into pairs, sorted. Work is
+    // split over jobs if it is not nullptr.
+    void FindPairs(const AabbSet& bodies, std::vector<BroadphasePair>& pairs, JobSystem* jobs);
+};
+
+} // namespace CookieEngine
+
+#endif
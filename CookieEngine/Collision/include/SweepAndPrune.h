@@ -0,0 +1,64 @@
+//
+//  SweepAndPrune.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_SweepAndPrune_h
+#define CookieEngine_SweepAndPrune_h
+
+#include "AabbSet.h"
+#include "BroadphasePair.h"
+#include "OverlapKernels.h"
+
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+// Sorts bodies along one axis and sweeps over the sorted list, testing each
+// body only against the following ones whose interval on that axis starts
+// before it ends. Those candidates are tested on all axes 4 at a time.
+// The sweep axis is the one the body centers spread most along, which keeps
+// the candidate lists short in flat or elongated scenes. The order is kept
+// between calls and repaired with an insertion sort, which is close to linear
+// while bodies move coherently from frame to frame. Added bodies are merged
+// into it and removed ones dropped, only a new sweep axis sorts from scratch.
+class SweepAndPrune
+{
+private:
+    std::vector<uint32_t> mOrder;
+    int mAxis;
+    Detail::BoundsStreams mSorted;
+    std::vector<std::vector<BroadphasePair> > mRangePairs;
+    
+    // Returns the axis with the largest variance of body centers, or the
+    // current one if it is nearly as good
+    int ChooseAxis(const AabbSet& bodies) const;
+    
+    // Brings mOrder up to date with the bodies and copies their bounds into mSorted
+    void SortBodies(const AabbSet& bodies);
+    
+    // Sweeps sorted positions [begin, end)
+    void Sweep(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const;
+    
+public:
+    SweepAndPrune();
+    
+    // Writes every overlapping pair of bodies into pairs, sorted. The sweep is
+    // split over jobs if it is not nullptr.
+    void FindPairs(const AabbSet& bodies, std::vector<BroadphasePair>& pairs, JobSystem* jobs);
+    
+    // Forgets the order, the next FindPairs sorts from scratch
+    void Reset();
+    
+    // Axis the last FindPairs swept along, 0 to 2 for x to z
+    __attribute__((always_inline)) int GetSweepAxis() const { return mAxis; }
+};
+
+} // namespace CookieEngine
+
+#endif
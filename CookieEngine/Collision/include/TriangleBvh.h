@@ -0,0 +1,113 @@
+//
+//  TriangleBvh.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_TriangleBvh_h
+#define CookieEngine_TriangleBvh_h
+
+#include "AlignedAllocator.h"
+#include "Ray.h"
+
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+class MeshFile;
+
+namespace Detail
+{
+
+// Children per node and triangles per block, one AVX lane each
+static const uint32_t kBvhWidth = 8;
+
+// Rows of BvhNode::bounds
+enum BoundsRow
+{
+    BoundsMinX = 0,
+    BoundsMinY,
+    BoundsMinZ,
+    BoundsMaxX,
+    BoundsMaxY,
+    BoundsMaxZ,
+};
+
+// Up to 8 child boxes as structure of arrays. Unused lanes hold an inverted
+// box (min +inf, max -inf) that no ray hits.
+struct BvhNode
+{
+    float bounds[6][kBvhWidth];
+    uint32_t children[kBvhWidth];
+    uint32_t childCount;
+    uint32_t leaf;          // children are TriangleBlock indices, not nodes
+    uint32_t padding[6];
+} __attribute__ ((aligned (32)));
+
+// 8 triangles as vertex 0 and the edges to vertices 1 and 2, the form the
+// Möller–Trumbore test reads. Unused lanes are degenerate and never hit.
+struct TriangleBlock
+{
+    float v0X[kBvhWidth];
+    float v0Y[kBvhWidth];
+    float v0Z[kBvhWidth];
+    float edge1X[kBvhWidth];
+    float edge1Y[kBvhWidth];
+    float edge1Z[kBvhWidth];
+    float edge2X[kBvhWidth];
+    float edge2Y[kBvhWidth];
+    float edge2Z[kBvhWidth];
+    uint32_t triangles[kBvhWidth];
+} __attribute__ ((aligned (32)));
+
+} // namespace Detail
+
+// Bounding volume hierarchy over a static triangle mesh for picking and
+// line of sight queries. Triangles are sorted along a Morton curve and packed
+// 8 to a block, and the blocks are grouped 8 to a node, level by level, up to
+// a single root. Each node visited costs one 8 wide box test and each block
+// one 8 wide triangle test.
+class TriangleBvh
+{
+private:
+    AlignedVector<Detail::BvhNode> mNodes;
+    AlignedVector<Detail::TriangleBlock> mBlocks;
+    uint32_t mTriangleCount;
+    
+public:
+    TriangleBvh();
+    
+    // Builds over triangleCount triangles of 3 indices each. positions points
+    // to the x of the first vertex and consecutive vertices are stride bytes
+    // apart. Returns false and stays empty if an index is out of range.
+    bool Build(const float* positions, uint32_t stride, uint32_t vertexCount,
+               const uint32_t* indices, uint32_t triangleCount);
+    
+    // Builds over the positions and indices of an open mesh file
+    bool Build(const MeshFile& mesh);
+    
+    void Clear();
+    
+    // Finds the closest triangle the ray hits within its maxDistance.
+    // Triangles are double sided. Returns false if there is none.
+    bool Intersect(const Ray& ray, RayHit& hit) const;
+    
+    // Returns true if the ray hits any triangle within its maxDistance. Cheaper
+    // than Intersect, traversal stops at the first hit.
+    bool IsOccluded(const Ray& ray) const;
+    
+    // Runs Intersect or IsOccluded for count rays, split over jobs if it is not nullptr
+    void Intersect(const Ray* rays, uint32_t count, RayHit* hits, JobSystem* jobs) const;
+    void IsOccluded(const Ray* rays, uint32_t count, bool* occluded, JobSystem* jobs) const;
+    
+    __attribute__((always_inline)) uint32_t GetTriangleCount() const { return mTriangleCount; }
+    __attribute__((always_inline)) uint32_t GetNodeCount() const { return (uint32_t)mNodes.size(); }
+    __attribute__((always_inline)) bool IsEmpty() const { return mNodes.empty(); }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,36 @@
+//
+//  AabbSet.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "AabbSet.h"
+
+namespace CookieEngine
+{
+
+uint32_t AabbSet::Add(const Vector3& min, const Vector3& max)
+{
+    uint32_t id = GetCount();
+    Resize(id + 1);
+    Set(id, min, max);
+    return id;
+}
+
+void AabbSet::Resize(uint32_t count)
+{
+    mMinX.resize(count, 0.0f);
+    mMinY.resize(count, 0.0f);
+    mMinZ.resize(count, 0.0f);
+    mMaxX.resize(count, 0.0f);
+    mMaxY.resize(count, 0.0f);
+    mMaxZ.resize(count, 0.0f);
+}
+
+void AabbSet::Clear()
+{
+    Resize(0);
+}
+
+} // namespace CookieEngine
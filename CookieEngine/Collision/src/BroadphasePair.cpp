@@ -0,0 +1,34 @@
+//
+//  BroadphasePair.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "BroadphasePair.h"
+
+#include <algorithm>
+
+namespace CookieEngine
+{
+
+void MergePairs(std::vector<std::vector<BroadphasePair> >& rangePairs, std::vector<BroadphasePair>& out)
+{
+    size_t total = 0;
+    for(size_t i = 0; i < rangePairs.size(); i++)
+    {
+        total += rangePairs[i].size();
+    }
+    
+    out.clear();
+    out.reserve(total);
+    for(size_t i = 0; i < rangePairs.size(); i++)
+    {
+        out.insert(out.end(), rangePairs[i].begin(), rangePairs[i].end());
+        rangePairs[i].clear();
+    }
+    
+    std::sort(out.begin(), out.end());
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,41 @@
+//
+//  Ray.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Ray.h"
+
+#include <cmath>
+
+namespace CookieEngine
+{
+
+Ray ScreenPointToRay(float x, float y, float width, float height, const Matrix4& view, const Matrix4& projection)
+{
+    // Clip space of CreatePerspective has depth 0 on the near and 1 on the far plane
+    Matrix4 inverse = Concatenate(projection, view);
+    if(!inverse.Invert())
+    {
+        return Ray();
+    }
+    
+    float ndcX = 2.0f * x / width - 1.0f;
+    float ndcY = 1.0f - 2.0f * y / height;
+    
+    Vector3 nearPoint(ndcX, ndcY, 0.0f, 1.0f);
+    Vector3 farPoint(ndcX, ndcY, 1.0f, 1.0f);
+    nearPoint.Transform(inverse);
+    farPoint.Transform(inverse);
+    nearPoint *= 1.0f / nearPoint.GetW();
+    farPoint *= 1.0f / farPoint.GetW();
+    
+    Vector3 direction = farPoint - nearPoint;
+    direction *= 1.0f / sqrtf(direction.Dot(direction));
+    direction.SetW(0.0f);
+    
+    return Ray(nearPoint, direction);
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,247 @@
+//
+//  RayKernels.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "RayKernels.h"
+
+#include <immintrin.h>
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+RayState::RayState(const Ray& ray)
+{
+    origin[0] = ray.origin.GetX();
+    origin[1] = ray.origin.GetY();
+    origin[2] = ray.origin.GetZ();
+    direction[0] = ray.direction.GetX();
+    direction[1] = ray.direction.GetY();
+    direction[2] = ray.direction.GetZ();
+    for(int axis = 0; axis < 3; axis++)
+    {
+        // A zero component gives an infinite inverse, the slab test then only
+        // passes boxes whose slab contains the origin
+        inverseDirection[axis] = 1.0f / direction[axis];
+        bool positive = !(inverseDirection[axis] < 0.0f);
+        nearRow[axis] = positive ? BoundsMinX + axis : BoundsMaxX + axis;
+        farRow[axis] = positive ? BoundsMaxX + axis : BoundsMinX + axis;
+    }
+}
+
+namespace
+{
+    // Slab test of 4 boxes. Entering through the near row and leaving through
+    // the far row, picked once per ray by direction sign, needs no min/max per
+    // axis and lets the inverted empty lanes fail. The possibly NaN (0 * inf)
+    // operand goes first so max and min drop it.
+    __attribute__((always_inline)) inline uint32_t IntersectBoxes4(const BvhNode& node, const RayState& ray, uint32_t lane,
+                                                                   __m128 maxDistance, float* tNear)
+    {
+        __m128 nearX = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.nearRow[0]][lane]), _mm_set_ps1(ray.origin[0])),
+                                  _mm_set_ps1(ray.inverseDirection[0]));
+        __m128 nearY = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.nearRow[1]][lane]), _mm_set_ps1(ray.origin[1])),
+                                  _mm_set_ps1(ray.inverseDirection[1]));
+        __m128 nearZ = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.nearRow[2]][lane]), _mm_set_ps1(ray.origin[2])),
+                                  _mm_set_ps1(ray.inverseDirection[2]));
+        __m128 farX = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.farRow[0]][lane]), _mm_set_ps1(ray.origin[0])),
+                                 _mm_set_ps1(ray.inverseDirection[0]));
+        __m128 farY = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.farRow[1]][lane]), _mm_set_ps1(ray.origin[1])),
+                                 _mm_set_ps1(ray.inverseDirection[1]));
+        __m128 farZ = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.bounds[ray.farRow[2]][lane]), _mm_set_ps1(ray.origin[2])),
+                                 _mm_set_ps1(ray.inverseDirection[2]));
+        
+        __m128 entry = _mm_max_ps(nearX, _mm_max_ps(nearY, _mm_max_ps(nearZ, _mm_setzero_ps())));
+        __m128 exit = _mm_min_ps(farX, _mm_min_ps(farY, _mm_min_ps(farZ, maxDistance)));
+        _mm_store_ps(tNear + lane, entry);
+        return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(entry, exit)) << lane;
+    }
+    
+    uint32_t IntersectBoxesSse(const BvhNode& node, const RayState& ray, float maxDistance, float* tNear)
+    {
+        __m128 tMax = _mm_set_ps1(maxDistance);
+        return IntersectBoxes4(node, ray, 0, tMax, tNear) | IntersectBoxes4(node, ray, 4, tMax, tNear);
+    }
+    
+    // Möller–Trumbore on triangles lane..lane+3. Returns the mask of triangles
+    // hit closer than maxDistance and writes their distances and barycentrics.
+    __attribute__((always_inline)) inline uint32_t IntersectTriangles4(const TriangleBlock& block, const RayState& ray, uint32_t lane,
+                                                                       __m128 maxDistance, __m128& t, __m128& u, __m128& v)
+    {
+        __m128 dx = _mm_set_ps1(ray.direction[0]);
+        __m128 dy = _mm_set_ps1(ray.direction[1]);
+        __m128 dz = _mm_set_ps1(ray.direction[2]);
+        __m128 e1x = _mm_load_ps(block.edge1X + lane);
+        __m128 e1y = _mm_load_ps(block.edge1Y + lane);
+        __m128 e1z = _mm_load_ps(block.edge1Z + lane);
+        __m128 e2x = _mm_load_ps(block.edge2X + lane);
+        __m128 e2y = _mm_load_ps(block.edge2Y + lane);
+        __m128 e2z = _mm_load_ps(block.edge2Z + lane);
+        
+        // p = direction x edge2
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 invDet = _mm_div_ps(_mm_set_ps1(1.0f), det);
+        
+        // s = origin - v0, q = s x edge1
+        __m128 sx = _mm_sub_ps(_mm_set_ps1(ray.origin[0]), _mm_load_ps(block.v0X + lane));
+        __m128 sy = _mm_sub_ps(_mm_set_ps1(ray.origin[1]), _mm_load_ps(block.v0Y + lane));
+        __m128 sz = _mm_sub_ps(_mm_set_ps1(ray.origin[2]), _mm_load_ps(block.v0Z + lane));
+        u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+        
+        // Degenerate padding triangles have a zero determinant, which makes u NaN and fails every compare
+        __m128 zero = _mm_setzero_ps();
+        __m128 low = _mm_set_ps1(-kEdgeTolerance);
+        __m128 hit = _mm_and_ps(_mm_cmpge_ps(u, low), _mm_cmpge_ps(v, low));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set_ps1(1.0f + kEdgeTolerance)));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, maxDistance)));
+        return (uint32_t)_mm_movemask_ps(hit);
+    }
+    
+    // Replaces hit by the closest of the triangles in mask
+    __attribute__((always_inline)) inline void TakeClosest(const TriangleBlock& block, uint32_t lane, uint32_t mask,
+                                                           __m128 t, __m128 u, __m128 v, RayHit& hit)
+    {
+        __m128 masked = _mm_blendv_ps(_mm_set_ps1(hit.distance), t, _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int)mask), _mm_setr_epi32(1, 2, 4, 8)), _mm_setr_epi32(1, 2, 4, 8))));
+        __m128 closest = _mm_min_ps(masked, _mm_shuffle_ps(masked, masked, _MM_SHUFFLE(2, 3, 0, 1)));
+        closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(1, 0, 3, 2)));
+        uint32_t i = (uint32_t)__builtin_ctz((uint32_t)_mm_movemask_ps(_mm_cmpeq_ps(masked, closest)) & mask);
+        
+        float us[4] __attribute__ ((aligned (16)));
+        float vs[4] __attribute__ ((aligned (16)));
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+        hit.distance = _mm_cvtss_f32(closest);
+        hit.triangle = block.triangles[lane + i];
+        hit.u = us[i];
+        hit.v = vs[i];
+    }
+    
+    bool IntersectTrianglesSse(const TriangleBlock& block, const RayState& ray, RayHit& hit)
+    {
+        bool found = false;
+        for(uint32_t lane = 0; lane < kBvhWidth; lane += 4)
+        {
+            __m128 t, u, v;
+            uint32_t mask = IntersectTriangles4(block, ray, lane, _mm_set_ps1(hit.distance), t, u, v);
+            if(mask)
+            {
+                TakeClosest(block, lane, mask, t, u, v, hit);
+                found = true;
+            }
+        }
+        return found;
+    }
+    
+    __attribute__((target("avx2,fma")))
+    uint32_t IntersectBoxesAvx2(const BvhNode& node, const RayState& ray, float maxDistance, float* tNear)
+    {
+        __m256 ox = _mm256_set1_ps(ray.origin[0]);
+        __m256 oy = _mm256_set1_ps(ray.origin[1]);
+        __m256 oz = _mm256_set1_ps(ray.origin[2]);
+        __m256 ix = _mm256_set1_ps(ray.inverseDirection[0]);
+        __m256 iy = _mm256_set1_ps(ray.inverseDirection[1]);
+        __m256 iz = _mm256_set1_ps(ray.inverseDirection[2]);
+        
+        __m256 nearX = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearRow[0]]), ox), ix);
+        __m256 nearY = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearRow[1]]), oy), iy);
+        __m256 nearZ = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearRow[2]]), oz), iz);
+        __m256 farX = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.farRow[0]]), ox), ix);
+        __m256 farY = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.farRow[1]]), oy), iy);
+        __m256 farZ = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.farRow[2]]), oz), iz);
+        
+        __m256 entry = _mm256_max_ps(nearX, _mm256_max_ps(nearY, _mm256_max_ps(nearZ, _mm256_setzero_ps())));
+        __m256 exit = _mm256_min_ps(farX, _mm256_min_ps(farY, _mm256_min_ps(farZ, _mm256_set1_ps(maxDistance))));
+        _mm256_store_ps(tNear, entry);
+        return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(entry, exit, _CMP_LE_OQ));
+    }
+    
+    __attribute__((target("avx2,fma")))
+    bool IntersectTrianglesAvx2(const TriangleBlock& block, const RayState& ray, RayHit& hit)
+    {
+        __m256 dx = _mm256_set1_ps(ray.direction[0]);
+        __m256 dy = _mm256_set1_ps(ray.direction[1]);
+        __m256 dz = _mm256_set1_ps(ray.direction[2]);
+        __m256 e1x = _mm256_load_ps(block.edge1X);
+        __m256 e1y = _mm256_load_ps(block.edge1Y);
+        __m256 e1z = _mm256_load_ps(block.edge1Z);
+        __m256 e2x = _mm256_load_ps(block.edge2X);
+        __m256 e2y = _mm256_load_ps(block.edge2Y);
+        __m256 e2z = _mm256_load_ps(block.edge2Z);
+        
+        // p = direction x edge2
+        __m256 px = _mm256_fmsub_ps(dy, e2z, _mm256_mul_ps(dz, e2y));
+        __m256 py = _mm256_fmsub_ps(dz, e2x, _mm256_mul_ps(dx, e2z));
+        __m256 pz = _mm256_fmsub_ps(dx, e2y, _mm256_mul_ps(dy, e2x));
+        __m256 det = _mm256_fmadd_ps(e1x, px, _mm256_fmadd_ps(e1y, py, _mm256_mul_ps(e1z, pz)));
+        __m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+        
+        // s = origin - v0, q = s x edge1
+        __m256 sx = _mm256_sub_ps(_mm256_set1_ps(ray.origin[0]), _mm256_load_ps(block.v0X));
+        __m256 sy = _mm256_sub_ps(_mm256_set1_ps(ray.origin[1]), _mm256_load_ps(block.v0Y));
+        __m256 sz = _mm256_sub_ps(_mm256_set1_ps(ray.origin[2]), _mm256_load_ps(block.v0Z));
+        __m256 u = _mm256_mul_ps(_mm256_fmadd_ps(sx, px, _mm256_fmadd_ps(sy, py, _mm256_mul_ps(sz, pz))), invDet);
+        __m256 qx = _mm256_fmsub_ps(sy, e1z, _mm256_mul_ps(sz, e1y));
+        __m256 qy = _mm256_fmsub_ps(sz, e1x, _mm256_mul_ps(sx, e1z));
+        __m256 qz = _mm256_fmsub_ps(sx, e1y, _mm256_mul_ps(sy, e1x));
+        __m256 v = _mm256_mul_ps(_mm256_fmadd_ps(dx, qx, _mm256_fmadd_ps(dy, qy, _mm256_mul_ps(dz, qz))), invDet);
+        __m256 t = _mm256_mul_ps(_mm256_fmadd_ps(e2x, qx, _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2z, qz))), invDet);
+        
+        __m256 zero = _mm256_setzero_ps();
+        __m256 closest = _mm256_set1_ps(hit.distance);
+        __m256 low = _mm256_set1_ps(-kEdgeTolerance);
+        __m256 hits = _mm256_and_ps(_mm256_cmp_ps(u, low, _CMP_GE_OQ), _mm256_cmp_ps(v, low, _CMP_GE_OQ));
+        hits = _mm256_and_ps(hits, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1.0f + kEdgeTolerance), _CMP_LE_OQ));
+        hits = _mm256_and_ps(hits, _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GE_OQ), _mm256_cmp_ps(t, closest, _CMP_LT_OQ)));
+        uint32_t mask = (uint32_t)_mm256_movemask_ps(hits);
+        if(!mask)
+        {
+            return false;
+        }
+        
+        __m256 masked = _mm256_blendv_ps(closest, t, hits);
+        __m256 nearest = _mm256_min_ps(masked, _mm256_permute2f128_ps(masked, masked, 1));
+        nearest = _mm256_min_ps(nearest, _mm256_shuffle_ps(nearest, nearest, _MM_SHUFFLE(2, 3, 0, 1)));
+        nearest = _mm256_min_ps(nearest, _mm256_shuffle_ps(nearest, nearest, _MM_SHUFFLE(1, 0, 3, 2)));
+        uint32_t i = (uint32_t)__builtin_ctz((uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(masked, nearest, _CMP_EQ_OQ)) & mask);
+        
+        float us[kBvhWidth] __attribute__ ((aligned (32)));
+        float vs[kBvhWidth] __attribute__ ((aligned (32)));
+        _mm256_store_ps(us, u);
+        _mm256_store_ps(vs, v);
+        hit.distance = _mm256_cvtss_f32(nearest);
+        hit.triangle = block.triangles[i];
+        hit.u = us[i];
+        hit.v = vs[i];
+        return true;
+    }
+    
+    // Kept out of Detail, the particle kernels export a HasAvx2 of their own
+    bool HasAvx2Fma()
+    {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+} // namespace
+
+const RayKernels& GetRayKernels()
+{
+    static const RayKernels sse = { IntersectBoxesSse, IntersectTrianglesSse };
+    static const RayKernels avx2 = { IntersectBoxesAvx2, IntersectTrianglesAvx2 };
+    static const bool hasAvx2 = HasAvx2Fma();
+    return hasAvx2 ? avx2 : sse;
+}
+
+} // namespace Detail
+} // namespace CookieEngine
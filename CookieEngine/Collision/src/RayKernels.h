@@ -0,0 +1,56 @@
+//
+//  RayKernels.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_RayKernels_h
+#define CookieEngine_RayKernels_h
+
+#include "Ray.h"
+#include "TriangleBvh.h"
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+// How far outside a triangle, in barycentric units, a hit still counts. Möller–Trumbore
+// computes the two triangles of a shared edge from different vertices, so a ray
+// through the edge can round to outside both and slip between them.
+static const float kEdgeTolerance = 1e-4f;
+
+// A single ray prepared for the box and triangle kernels
+struct RayState
+{
+    float origin[3];
+    float direction[3];
+    float inverseDirection[3];
+    int nearRow[3];         // BvhNode::bounds row a ray enters through on each axis
+    int farRow[3];
+    
+    explicit RayState(const Ray& ray);
+};
+
+// Tests the ray against the 8 boxes of node over [0, maxDistance]. Returns a
+// mask of the boxes hit and writes the distance it enters each one to tNear.
+typedef uint32_t (*BoxKernel)(const BvhNode& node, const RayState& ray, float maxDistance, float* tNear);
+
+// Tests the ray against the 8 triangles of block. If one is hit closer than
+// hit.distance, hit is replaced by the closest one and the kernel returns true.
+typedef bool (*TriangleKernel)(const TriangleBlock& block, const RayState& ray, RayHit& hit);
+
+struct RayKernels
+{
+    BoxKernel boxes;
+    TriangleKernel triangles;
+};
+
+// Returns the AVX2 kernels if the CPU runs them and the SSE kernels otherwise
+const RayKernels& GetRayKernels();
+
+} // namespace Detail
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,347 @@
+//
+//  SpatialHashGrid.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "SpatialHashGrid.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CookieEngine
+{
+
+// Cell coordinates are packed into 21 bits per axis, so a key is a single
+// 64-bit integer and sorting by it groups the entries of a cell together
+static const int32_t kCellBias = 1 << 20;
+static const uint32_t kCellBits = 21;
+static const uint64_t kCellMask = (1u << kCellBits) - 1;
+
+static const uint32_t kBodyGrainSize = 4096;
+static const uint32_t kCellGrainSize = 2048;
+static const uint32_t kLargeBodyGrainSize = 16;
+
+// Radix sort digit size, 2048 counters fit in L1
+static const uint32_t kRadixBits = 11;
+
+namespace
+{
+    __attribute__((always_inline)) inline uint64_t MakeKey(int32_t x, int32_t y, int32_t z)
+    {
+        return ((uint64_t)(x + kCellBias) << (2 * kCellBits)) | ((uint64_t)(y + kCellBias) << kCellBits) |
+               (uint64_t)(z + kCellBias);
+    }
+    
+    __attribute__((always_inline)) inline int32_t KeyCell(uint64_t key, uint32_t axis)
+    {
+        return (int32_t)((key >> ((2 - axis) * kCellBits)) & kCellMask) - kCellBias;
+    }
+    
+    // Runs func over [0, count) split over jobs, or inline without them
+    void RunRanges(JobSystem* jobs, uint32_t count, uint32_t grainSize, const JobSystem::RangeFunction& func)
+    {
+        if(jobs && count > grainSize)
+        {
+            jobs->ParallelFor(count, grainSize, func);
+        }
+        else if(count > 0)
+        {
+            func(0, count);
+        }
+    }
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) : mCellSize(1.0f), mInvCellSize(1.0f)
+{
+    SetCellSize(cellSize);
+}
+
+void SpatialHashGrid::SetCellSize(float cellSize)
+{
+    mCellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    mInvCellSize = 1.0f / mCellSize;
+}
+
+int32_t SpatialHashGrid::GetCell(float x) const
+{
+    // Clamped so far away bodies share the border cells instead of wrapping, NaN ends up in the lowest cell
+    float cell = floorf(x * mInvCellSize);
+    cell = cell > (float)-kCellBias ? cell : (float)-kCellBias;
+    cell = cell < (float)(kCellBias - 1) ? cell : (float)(kCellBias - 1);
+    return (int32_t)cell;
+}
+
+void SpatialHashGrid::CountEntries(const AabbSet& bodies, uint32_t begin, uint32_t end)
+{
+    for(uint32_t i = begin; i < end; i++)
+    {
+        uint64_t cellsX = (uint64_t)(GetCell(bodies.GetMaxX()[i]) - GetCell(bodies.GetMinX()[i]) + 1);
+        uint64_t cellsY = (uint64_t)(GetCell(bodies.GetMaxY()[i]) - GetCell(bodies.GetMinY()[i]) + 1);
+        uint64_t cellsZ = (uint64_t)(GetCell(bodies.GetMaxZ()[i]) - GetCell(bodies.GetMinZ()[i]) + 1);
+        
+        // Inverted boxes count as one cell, they overlap nothing anyway
+        cellsX = cellsX > 0 && cellsX <= kCellMask ? cellsX : 1;
+        cellsY = cellsY > 0 && cellsY <= kCellMask ? cellsY : 1;
+        cellsZ = cellsZ > 0 && cellsZ <= kCellMask ? cellsZ : 1;
+        uint64_t cells = cellsX * cellsY * cellsZ;
+        
+        mIsLarge[i] = cells > kMaxCellsPerBody;
+        mEntryOffsets[i] = mIsLarge[i] ? 0 : (uint32_t)cells;
+    }
+}
+
+void SpatialHashGrid::FillEntries(const AabbSet& bodies, uint32_t begin, uint32_t end)
+{
+    for(uint32_t i = begin; i < end; i++)
+    {
+        uint32_t entry = mEntryOffsets[i];
+        if(mEntryOffsets[i + 1] == entry)
+        {
+            continue;
+        }
+        
+        int32_t minX = GetCell(bodies.GetMinX()[i]);
+        int32_t minY = GetCell(bodies.GetMinY()[i]);
+        int32_t minZ = GetCell(bodies.GetMinZ()[i]);
+        int32_t maxX = std::max(GetCell(bodies.GetMaxX()[i]), minX);
+        int32_t maxY = std::max(GetCell(bodies.GetMaxY()[i]), minY);
+        int32_t maxZ = std::max(GetCell(bodies.GetMaxZ()[i]), minZ);
+        
+        for(int32_t x = minX; x <= maxX; x++)
+        {
+            for(int32_t y = minY; y <= maxY; y++)
+            {
+                for(int32_t z = minZ; z <= maxZ; z++)
+                {
+                    mEntries[entry].key = MakeKey(x, y, z);
+                    mEntries[entry].body = i;
+                    entry++;
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::SortEntries()
+{
+    // Keys of nearby cells share their high bits, only the differing low bits
+    // need sorting. That is usually 2 or 3 passes instead of 6.
+    uint32_t count = (uint32_t)mEntries.size();
+    if(count < 2)
+    {
+        return;
+    }
+    
+    uint64_t differing = 0;
+    uint64_t first = mEntries[0].key;
+    for(uint32_t e = 1; e < count; e++)
+    {
+        differing |= mEntries[e].key ^ first;
+    }
+    uint32_t bits = differing ? 64 - (uint32_t)__builtin_clzll(differing) : 0;
+    
+    // LSD radix sort is stable, so entries of a cell stay in body order as filled
+    mSortScratch.resize(count);
+    std::vector<uint32_t> counts(1u << kRadixBits);
+    for(uint32_t shift = 0; shift < bits; shift += kRadixBits)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        for(uint32_t e = 0; e < count; e++)
+        {
+            counts[(mEntries[e].key >> shift) & ((1u << kRadixBits) - 1)]++;
+        }
+        
+        uint32_t offset = 0;
+        for(size_t d = 0; d < counts.size(); d++)
+        {
+            uint32_t digitCount = counts[d];
+            counts[d] = offset;
+            offset += digitCount;
+        }
+        
+        for(uint32_t e = 0; e < count; e++)
+        {
+            const CellEntry& entry = mEntries[e];
+            mSortScratch[counts[(entry.key >> shift) & ((1u << kRadixBits) - 1)]++] = entry;
+        }
+        mEntries.swap(mSortScratch);
+    }
+}
+
+void SpatialHashGrid::TestCells(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const
+{
+    const Detail::BoundsStreams& bounds = mEntryBounds;
+    
+    for(uint32_t c = begin; c < end; c++)
+    {
+        uint32_t first = mCellStarts[c];
+        uint32_t last = mCellStarts[c + 1];
+        if(last - first < 2)
+        {
+            continue;
+        }
+        
+        uint64_t key = mEntries[first].key;
+        int32_t cellX = KeyCell(key, 0);
+        int32_t cellY = KeyCell(key, 1);
+        int32_t cellZ = KeyCell(key, 2);
+        
+        for(uint32_t i = first; i < last; i++)
+        {
+            Detail::OverlapQuery query(bounds, i);
+            
+            for(uint32_t j = i + 1; j < last; j += Detail::kOverlapLanes)
+            {
+                int mask = Detail::TestOverlap4(query, bounds, j);
+                if(last - j < Detail::kOverlapLanes)
+                {
+                    // Entries past the cell belong to the next one
+                    mask &= (1 << (last - j)) - 1;
+                }
+                
+                while(mask)
+                {
+                    uint32_t other = j + (uint32_t)__builtin_ctz(mask);
+                    mask &= mask - 1;
+                    
+                    // Only the cell holding the min corner of the overlap reports the pair
+                    if(GetCell(std::max(bounds.minX[i], bounds.minX[other])) == cellX &&
+                       GetCell(std::max(bounds.minY[i], bounds.minY[other])) == cellY &&
+                       GetCell(std::max(bounds.minZ[i], bounds.minZ[other])) == cellZ)
+                    {
+                        Detail::AddPair(pairs, mEntries[i].body, mEntries[other].body);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::TestLargeBodies(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const
+{
+    uint32_t count = (uint32_t)mIsLarge.size();
+    
+    for(uint32_t l = begin; l < end; l++)
+    {
+        uint32_t body = mLargeBodies[l];
+        Detail::OverlapQuery query(mBodyBounds, body);
+        
+        for(uint32_t j = 0; j < count; j += Detail::kOverlapLanes)
+        {
+            int mask = Detail::TestOverlap4(query, mBodyBounds, j);
+            while(mask)
+            {
+                uint32_t other = j + (uint32_t)__builtin_ctz(mask);
+                mask &= mask - 1;
+                
+                // Two large bodies find each other, only the smaller id reports
+                if(other != body && (!mIsLarge[other] || body < other))
+                {
+                    Detail::AddPair(pairs, body, other);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::FindPairs(const AabbSet& bodies, std::vector<BroadphasePair>& pairs, JobSystem* jobs)
+{
+    uint32_t count = bodies.GetCount();
+    mEntryOffsets.resize(count + 1);
+    mIsLarge.resize(count);
+    
+    RunRanges(jobs, count, kBodyGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        CountEntries(bodies, begin, end);
+    });
+    
+    // Counts to offsets
+    uint32_t total = 0;
+    mLargeBodies.clear();
+    for(uint32_t i = 0; i < count; i++)
+    {
+        uint32_t cells = mEntryOffsets[i];
+        mEntryOffsets[i] = total;
+        total += cells;
+        if(mIsLarge[i])
+        {
+            mLargeBodies.push_back(i);
+        }
+    }
+    mEntryOffsets[count] = total;
+    
+    mEntries.resize(total);
+    mBodies.resize(count);
+    RunRanges(jobs, count, kBodyGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        FillEntries(bodies, begin, end);
+        for(uint32_t i = begin; i < end; i++)
+        {
+            BodyBounds& body = mBodies[i];
+            body.min[0] = bodies.GetMinX()[i];
+            body.min[1] = bodies.GetMinY()[i];
+            body.min[2] = bodies.GetMinZ()[i];
+            body.max[0] = bodies.GetMaxX()[i];
+            body.max[1] = bodies.GetMaxY()[i];
+            body.max[2] = bodies.GetMaxZ()[i];
+        }
+    });
+    SortEntries();
+    
+    mCellStarts.clear();
+    for(uint32_t e = 0; e < total; e++)
+    {
+        if(e == 0 || mEntries[e].key != mEntries[e - 1].key)
+        {
+            mCellStarts.push_back(e);
+        }
+    }
+    uint32_t cellCount = (uint32_t)mCellStarts.size();
+    mCellStarts.push_back(total);
+    
+    mEntryBounds.Resize(total);
+    RunRanges(jobs, total, kBodyGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t e = begin; e < end; e++)
+        {
+            const BodyBounds& body = mBodies[mEntries[e].body];
+            mEntryBounds.minX[e] = body.min[0];
+            mEntryBounds.minY[e] = body.min[1];
+            mEntryBounds.minZ[e] = body.min[2];
+            mEntryBounds.maxX[e] = body.max[0];
+            mEntryBounds.maxY[e] = body.max[1];
+            mEntryBounds.maxZ[e] = body.max[2];
+        }
+    });
+    
+    uint32_t largeCount = (uint32_t)mLargeBodies.size();
+    if(largeCount > 0)
+    {
+        mBodyBounds.Resize(count);
+        for(uint32_t i = 0; i < count; i++)
+        {
+            mBodyBounds.Copy(i, bodies, i);
+        }
+    }
+    
+    uint32_t cellRanges = (cellCount + kCellGrainSize - 1) / kCellGrainSize;
+    uint32_t largeRanges = (largeCount + kLargeBodyGrainSize - 1) / kLargeBodyGrainSize;
+    mRangePairs.resize(cellRanges + largeRanges);
+    
+    RunRanges(jobs, cellCount, kCellGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        // Without jobs this is one call over every cell
+        TestCells(begin, end, mRangePairs[begin / kCellGrainSize]);
+    });
+    RunRanges(jobs, largeCount, kLargeBodyGrainSize, [&](uint32_t begin, uint32_t end)
+    {
+        TestLargeBodies(begin, end, mRangePairs[cellRanges + begin / kLargeBodyGrainSize]);
+    });
+    
+    MergePairs(mRangePairs, pairs);
+}
+
+} // namespace CookieEngine
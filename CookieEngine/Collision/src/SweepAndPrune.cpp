@@ -0,0 +1,205 @@
+//
+//  SweepAndPrune.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "SweepAndPrune.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace CookieEngine
+{
+
+// Sorted positions per job. Sweep cost per body varies with how crowded its
+// neighbourhood is, so ranges are kept small to balance the threads.
+static const uint32_t kSweepGrainSize = 1024;
+
+namespace
+{
+    // Orders by min on the sweep axis and breaks ties by id, so the order never depends on history
+    struct MinLess
+    {
+        const float* min;
+        
+        __attribute__((always_inline)) bool operator()(uint32_t lhs, uint32_t rhs) const
+        {
+            return min[lhs] != min[rhs] ? min[lhs] < min[rhs] : lhs < rhs;
+        }
+    };
+} // namespace
+
+SweepAndPrune::SweepAndPrune() : mOrder(), mAxis(0), mSorted(), mRangePairs()
+{
+}
+
+int SweepAndPrune::ChooseAxis(const AabbSet& bodies) const
+{
+    const float* mins[3] = { bodies.GetMinX(), bodies.GetMinY(), bodies.GetMinZ() };
+    const float* maxs[3] = { bodies.GetMaxX(), bodies.GetMaxY(), bodies.GetMaxZ() };
+    uint32_t count = bodies.GetCount();
+    if(count == 0)
+    {
+        return mAxis;
+    }
+    
+    double variance[3];
+    for(int a = 0; a < 3; a++)
+    {
+        // Twice the center, the factor does not change which axis wins
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        for(uint32_t i = 0; i < count; i++)
+        {
+            double center = (double)mins[a][i] + (double)maxs[a][i];
+            sum += center;
+            sumSquares += center * center;
+        }
+        
+        double mean = sum / count;
+        variance[a] = sumSquares / count - mean * mean;
+    }
+    
+    int best = variance[0] >= variance[1] ? 0 : 1;
+    best = variance[best] >= variance[2] ? best : 2;
+    
+    // Switching costs a full sort, so only switch for a clearly better axis
+    return mOrder.empty() || variance[best] > variance[mAxis] * 1.25 ? best : mAxis;
+}
+
+void SweepAndPrune::SortBodies(const AabbSet& bodies)
+{
+    uint32_t count = bodies.GetCount();
+    
+    int axis = ChooseAxis(bodies);
+    const float* mins[3] = { bodies.GetMinX(), bodies.GetMinY(), bodies.GetMinZ() };
+    const float* maxs[3] = { bodies.GetMaxX(), bodies.GetMaxY(), bodies.GetMaxZ() };
+    MinLess less = { mins[axis] };
+    
+    if(mOrder.empty() || axis != mAxis)
+    {
+        // Nothing sorted yet or the axis changed, the old order is worth little
+        mAxis = axis;
+        mOrder.resize(count);
+        for(uint32_t i = 0; i < count; i++)
+        {
+            mOrder[i] = i;
+        }
+        std::sort(mOrder.begin(), mOrder.end(), less);
+    }
+    else
+    {
+        // Bodies removed from the end drop out, the survivors keep their order
+        uint32_t previousCount = (uint32_t)mOrder.size();
+        if(previousCount > count)
+        {
+            mOrder.erase(std::remove_if(mOrder.begin(), mOrder.end(), [count](uint32_t id) { return id >= count; }),
+                         mOrder.end());
+        }
+        
+        uint32_t kept = (uint32_t)mOrder.size();
+        for(uint32_t i = 1; i < kept; i++)
+        {
+            uint32_t id = mOrder[i];
+            uint32_t j = i;
+            while(j > 0 && less(id, mOrder[j - 1]))
+            {
+                mOrder[j] = mOrder[j - 1];
+                j--;
+            }
+            mOrder[j] = id;
+        }
+        
+        // Bodies added since the last call are sorted among themselves and merged
+        // in, which is inserting each into place without walking the list per body
+        for(uint32_t id = previousCount; id < count; id++)
+        {
+            mOrder.push_back(id);
+        }
+        if(kept < count)
+        {
+            std::sort(mOrder.begin() + kept, mOrder.end(), less);
+            std::inplace_merge(mOrder.begin(), mOrder.begin() + kept, mOrder.end(), less);
+        }
+    }
+    
+    // The sweep axis goes into the x streams, overlap tests do not care about axis order
+    int other0 = (axis + 1) % 3;
+    int other1 = (axis + 2) % 3;
+    mSorted.Resize(count);
+    for(uint32_t i = 0; i < count; i++)
+    {
+        uint32_t id = mOrder[i];
+        mSorted.minX[i] = mins[axis][id];
+        mSorted.maxX[i] = maxs[axis][id];
+        mSorted.minY[i] = mins[other0][id];
+        mSorted.maxY[i] = maxs[other0][id];
+        mSorted.minZ[i] = mins[other1][id];
+        mSorted.maxZ[i] = maxs[other1][id];
+    }
+}
+
+void SweepAndPrune::Sweep(uint32_t begin, uint32_t end, std::vector<BroadphasePair>& pairs) const
+{
+    const float* minX = mSorted.minX.data();
+    uint32_t count = (uint32_t)mOrder.size();
+    
+    for(uint32_t i = begin; i < end; i++)
+    {
+        Detail::OverlapQuery query(mSorted, i);
+        
+        for(uint32_t j = i + 1; j < count; j += Detail::kOverlapLanes)
+        {
+            // Sorted by min, so once a box starts past the end of box i all
+            // following ones do too. Lanes past count are padding that never overlaps.
+            if(minX[j] > mSorted.maxX[i])
+            {
+                break;
+            }
+            
+            int mask = Detail::TestOverlap4(query, mSorted, j);
+            while(mask)
+            {
+                int lane = __builtin_ctz(mask);
+                Detail::AddPair(pairs, mOrder[i], mOrder[j + lane]);
+                mask &= mask - 1;
+            }
+        }
+    }
+}
+
+void SweepAndPrune::FindPairs(const AabbSet& bodies, std::vector<BroadphasePair>& pairs, JobSystem* jobs)
+{
+    SortBodies(bodies);
+    
+    uint32_t count = bodies.GetCount();
+    uint32_t rangeCount = (count + kSweepGrainSize - 1) / kSweepGrainSize;
+    mRangePairs.resize(rangeCount);
+    
+    if(jobs && rangeCount > 1)
+    {
+        jobs->ParallelFor(count, kSweepGrainSize, [&](uint32_t begin, uint32_t end)
+        {
+            Sweep(begin, end, mRangePairs[begin / kSweepGrainSize]);
+        });
+    }
+    else
+    {
+        for(uint32_t r = 0; r < rangeCount; r++)
+        {
+            uint32_t begin = r * kSweepGrainSize;
+            Sweep(begin, std::min(begin + kSweepGrainSize, count), mRangePairs[r]);
+        }
+    }
+    
+    MergePairs(mRangePairs, pairs);
+}
+
+void SweepAndPrune::Reset()
+{
+    mOrder.clear();
+}
+
+} // namespace CookieEngine
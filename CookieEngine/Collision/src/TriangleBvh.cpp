@@ -0,0 +1,424 @@
+//
+//  TriangleBvh.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "TriangleBvh.h"
+#include "RayKernels.h"
+#include "JobSystem.h"
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Rays per job in the batch queries
+static const uint32_t kRayGrainSize = 64;
+
+// Nodes waiting on the traversal stack. Every level pushes at most 7 more
+// than it pops, so this covers trees of 9 levels, over 10^8 triangles.
+static const uint32_t kTraversalStackSize = 64;
+
+namespace
+{
+    struct Bounds
+    {
+        float min[3];
+        float max[3];
+    };
+    
+    struct StackEntry
+    {
+        uint32_t node;
+        float distance;
+    };
+    
+    __attribute__((always_inline)) inline const float* GetVertex(const float* positions, uint32_t stride, uint32_t i)
+    {
+        return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + (size_t)i * stride);
+    }
+    
+    // Spreads the low 10 bits of x so two zero bits follow each one
+    __attribute__((always_inline)) inline uint32_t SpreadBits(uint32_t x)
+    {
+        x = (x | (x << 16)) & 0x030000FF;
+        x = (x | (x << 8)) & 0x0300F00F;
+        x = (x | (x << 4)) & 0x030C30C3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+    }
+    
+    // Orders the lanes set in mask by distance, nearest first. Returns their count.
+    __attribute__((always_inline)) inline uint32_t SortLanes(uint32_t mask, const float* distance, uint32_t* lanes)
+    {
+        uint32_t count = 0;
+        while(mask)
+        {
+            uint32_t lane = (uint32_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+            
+            uint32_t j = count++;
+            while(j > 0 && distance[lanes[j - 1]] > distance[lane])
+            {
+                lanes[j] = lanes[j - 1];
+                j--;
+            }
+            lanes[j] = lane;
+        }
+        return count;
+    }
+    
+    // Writes 8 or fewer boxes into a node, inverting the unused lanes
+    void FillNode(Detail::BvhNode& node, const Bounds* bounds, uint32_t first, uint32_t count, bool leaf)
+    {
+        float infinity = std::numeric_limits<float>::infinity();
+        node.childCount = count;
+        node.leaf = leaf ? 1 : 0;
+        for(uint32_t i = 0; i < Detail::kBvhWidth; i++)
+        {
+            bool used = i < count;
+            for(int axis = 0; axis < 3; axis++)
+            {
+                node.bounds[Detail::BoundsMinX + axis][i] = used ? bounds[first + i].min[axis] : infinity;
+                node.bounds[Detail::BoundsMaxX + axis][i] = used ? bounds[first + i].max[axis] : -infinity;
+            }
+            node.children[i] = used ? first + i : 0;
+        }
+        std::fill(node.padding, node.padding + sizeof(node.padding) / sizeof(node.padding[0]), 0);
+    }
+} // namespace
+
+TriangleBvh::TriangleBvh() : mNodes(), mBlocks(), mTriangleCount(0)
+{
+}
+
+bool TriangleBvh::Build(const float* positions, uint32_t stride, uint32_t vertexCount,
+                        const uint32_t* indices, uint32_t triangleCount)
+{
+    Clear();
+    
+    for(uint32_t i = 0; i < triangleCount * 3; i++)
+    {
+        if(indices[i] >= vertexCount)
+        {
+            return false;
+        }
+    }
+    if(triangleCount == 0)
+    {
+        return true;
+    }
+    
+    // Centroid bounds for quantizing the Morton codes
+    float infinity = std::numeric_limits<float>::infinity();
+    Bounds centroids = { { infinity, infinity, infinity }, { -infinity, -infinity, -infinity } };
+    std::vector<float> centers(triangleCount * 3);
+    for(uint32_t t = 0; t < triangleCount; t++)
+    {
+        const float* a = GetVertex(positions, stride, indices[t * 3]);
+        const float* b = GetVertex(positions, stride, indices[t * 3 + 1]);
+        const float* c = GetVertex(positions, stride, indices[t * 3 + 2]);
+        for(int axis = 0; axis < 3; axis++)
+        {
+            float center = (a[axis] + b[axis] + c[axis]) * (1.0f / 3.0f);
+            centers[t * 3 + axis] = center;
+            centroids.min[axis] = std::min(centroids.min[axis], center);
+            centroids.max[axis] = std::max(centroids.max[axis], center);
+        }
+    }
+    
+    // Sorting by code in the high half and triangle in the low half keeps the build deterministic
+    std::vector<uint64_t> keys(triangleCount);
+    for(uint32_t t = 0; t < triangleCount; t++)
+    {
+        uint32_t code = 0;
+        for(int axis = 0; axis < 3; axis++)
+        {
+            float extent = centroids.max[axis] - centroids.min[axis];
+            float scale = extent > 0.0f ? 1023.0f / extent : 0.0f;
+            uint32_t cell = (uint32_t)((centers[t * 3 + axis] - centroids.min[axis]) * scale);
+            code |= SpreadBits(std::min(cell, 1023u)) << axis;
+        }
+        keys[t] = ((uint64_t)code << 32) | t;
+    }
+    std::sort(keys.begin(), keys.end());
+    
+    // Triangles into blocks of 8, the last one padded with degenerate triangles
+    uint32_t blockCount = (triangleCount + Detail::kBvhWidth - 1) / Detail::kBvhWidth;
+    mBlocks.resize(blockCount);
+    std::vector<Bounds> bounds(blockCount);
+    for(uint32_t b = 0; b < blockCount; b++)
+    {
+        Detail::TriangleBlock& block = mBlocks[b];
+        Bounds& box = bounds[b];
+        box = { { infinity, infinity, infinity }, { -infinity, -infinity, -infinity } };
+        for(uint32_t i = 0; i < Detail::kBvhWidth; i++)
+        {
+            uint32_t k = b * Detail::kBvhWidth + i;
+            if(k >= triangleCount)
+            {
+                block.v0X[i] = block.v0Y[i] = block.v0Z[i] = 0.0f;
+                block.edge1X[i] = block.edge1Y[i] = block.edge1Z[i] = 0.0f;
+                block.edge2X[i] = block.edge2Y[i] = block.edge2Z[i] = 0.0f;
+                block.triangles[i] = kNoHit;
+                continue;
+            }
+            
+            uint32_t t = (uint32_t)keys[k];
+            const float* v0 = GetVertex(positions, stride, indices[t * 3]);
+            const float* v1 = GetVertex(positions, stride, indices[t * 3 + 1]);
+            const float* v2 = GetVertex(positions, stride, indices[t * 3 + 2]);
+            block.v0X[i] = v0[0];
+            block.v0Y[i] = v0[1];
+            block.v0Z[i] = v0[2];
+            block.edge1X[i] = v1[0] - v0[0];
+            block.edge1Y[i] = v1[1] - v0[1];
+            block.edge1Z[i] = v1[2] - v0[2];
+            block.edge2X[i] = v2[0] - v0[0];
+            block.edge2Y[i] = v2[1] - v0[1];
+            block.edge2Z[i] = v2[2] - v0[2];
+            block.triangles[i] = t;
+            for(int axis = 0; axis < 3; axis++)
+            {
+                box.min[axis] = std::min(box.min[axis], std::min(v0[axis], std::min(v1[axis], v2[axis])));
+                box.max[axis] = std::max(box.max[axis], std::max(v0[axis], std::max(v1[axis], v2[axis])));
+            }
+        }
+    }
+    
+    // Groups of 8 consecutive blocks, then nodes, become the next level up
+    // until one node is left. Each level is appended after the previous one,
+    // so the root ends up last.
+    uint32_t levelFirst = 0;
+    uint32_t levelCount = blockCount;
+    bool leaf = true;
+    do
+    {
+        uint32_t parentFirst = (uint32_t)mNodes.size();
+        uint32_t parentCount = (levelCount + Detail::kBvhWidth - 1) / Detail::kBvhWidth;
+        mNodes.resize(parentFirst + parentCount);
+        std::vector<Bounds> parentBounds(parentCount);
+        for(uint32_t p = 0; p < parentCount; p++)
+        {
+            uint32_t first = p * Detail::kBvhWidth;
+            uint32_t count = std::min(Detail::kBvhWidth, levelCount - first);
+            Detail::BvhNode& node = mNodes[parentFirst + p];
+            FillNode(node, &bounds[0], first, count, leaf);
+            if(!leaf)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    node.children[i] += levelFirst;
+                }
+            }
+            
+            Bounds& box = parentBounds[p];
+            box = bounds[first];
+            for(uint32_t i = 1; i < count; i++)
+            {
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    box.min[axis] = std::min(box.min[axis], bounds[first + i].min[axis]);
+                    box.max[axis] = std::max(box.max[axis], bounds[first + i].max[axis]);
+                }
+            }
+        }
+        
+        bounds.swap(parentBounds);
+        levelFirst = parentFirst;
+        levelCount = parentCount;
+        leaf = false;
+    }
+    while(levelCount > 1);
+    
+    mTriangleCount = triangleCount;
+    return true;
+}
+
+bool TriangleBvh::Build(const MeshFile& mesh)
+{
+    const VertexAttributeDesc* position = mesh.FindAttribute(VertexAttribute::Position);
+    if(!position || position->components < 3)
+    {
+        Clear();
+        return false;
+    }
+    
+    const MeshFileHeader& header = mesh.GetHeader();
+    const float* positions = reinterpret_cast<const float*>(static_cast<const uint8_t*>(mesh.GetVertexData()) + position->offset);
+    
+    // 16 bit and missing index buffers are widened to 32 bits
+    std::vector<uint32_t> indices;
+    if(header.indexCount == 0)
+    {
+        indices.resize(header.vertexCount - header.vertexCount % 3);
+        for(uint32_t i = 0; i < (uint32_t)indices.size(); i++)
+        {
+            indices[i] = i;
+        }
+    }
+    else if(header.indexSize == 2)
+    {
+        const uint16_t* shortIndices = static_cast<const uint16_t*>(mesh.GetIndexData());
+        indices.assign(shortIndices, shortIndices + header.indexCount);
+    }
+    else
+    {
+        const uint32_t* longIndices = static_cast<const uint32_t*>(mesh.GetIndexData());
+        indices.assign(longIndices, longIndices + header.indexCount);
+    }
+    
+    uint32_t triangleCount = (uint32_t)indices.size() / 3;
+    return Build(positions, header.vertexStride, header.vertexCount, indices.empty() ? nullptr : &indices[0], triangleCount);
+}
+
+void TriangleBvh::Clear()
+{
+    mNodes.clear();
+    mBlocks.clear();
+    mTriangleCount = 0;
+}
+
+bool TriangleBvh::Intersect(const Ray& ray, RayHit& hit) const
+{
+    hit.distance = ray.maxDistance;
+    hit.triangle = kNoHit;
+    hit.u = 0.0f;
+    hit.v = 0.0f;
+    if(mNodes.empty())
+    {
+        return false;
+    }
+    
+    const Detail::RayKernels& kernels = Detail::GetRayKernels();
+    Detail::RayState state(ray);
+    StackEntry stack[kTraversalStackSize];
+    uint32_t top = 0;
+    stack[top].node = (uint32_t)mNodes.size() - 1;
+    stack[top].distance = 0.0f;
+    top++;
+    
+    float tNear[Detail::kBvhWidth] __attribute__ ((aligned (32)));
+    uint32_t lanes[Detail::kBvhWidth];
+    while(top > 0)
+    {
+        StackEntry entry = stack[--top];
+        if(entry.distance > hit.distance)
+        {
+            continue;
+        }
+        
+        const Detail::BvhNode& node = mNodes[entry.node];
+        uint32_t count = SortLanes(kernels.boxes(node, state, hit.distance, tNear), tNear, lanes);
+        if(node.leaf)
+        {
+            // Nearest block first, its hit shrinks the interval for the others
+            for(uint32_t i = 0; i < count; i++)
+            {
+                if(tNear[lanes[i]] <= hit.distance)
+                {
+                    kernels.triangles(mBlocks[node.children[lanes[i]]], state, hit);
+                }
+            }
+        }
+        else
+        {
+            // Farthest pushed first so the nearest is popped next
+            for(uint32_t i = count; i-- > 0;)
+            {
+                stack[top].node = node.children[lanes[i]];
+                stack[top].distance = tNear[lanes[i]];
+                top++;
+            }
+        }
+    }
+    return hit.triangle != kNoHit;
+}
+
+bool TriangleBvh::IsOccluded(const Ray& ray) const
+{
+    if(mNodes.empty())
+    {
+        return false;
+    }
+    
+    const Detail::RayKernels& kernels = Detail::GetRayKernels();
+    Detail::RayState state(ray);
+    RayHit hit;
+    hit.distance = ray.maxDistance;
+    hit.triangle = kNoHit;
+    
+    uint32_t stack[kTraversalStackSize];
+    uint32_t top = 0;
+    stack[top++] = (uint32_t)mNodes.size() - 1;
+    
+    float tNear[Detail::kBvhWidth] __attribute__ ((aligned (32)));
+    while(top > 0)
+    {
+        const Detail::BvhNode& node = mNodes[stack[--top]];
+        uint32_t mask = kernels.boxes(node, state, ray.maxDistance, tNear);
+        while(mask)
+        {
+            uint32_t lane = (uint32_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+            if(!node.leaf)
+            {
+                stack[top++] = node.children[lane];
+            }
+            else if(kernels.triangles(mBlocks[node.children[lane]], state, hit))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TriangleBvh::Intersect(const Ray* rays, uint32_t count, RayHit* hits, JobSystem* jobs) const
+{
+    if(jobs && count > kRayGrainSize)
+    {
+        jobs->ParallelFor(count, kRayGrainSize, [&](uint32_t begin, uint32_t end)
+        {
+            for(uint32_t i = begin; i < end; i++)
+            {
+                Intersect(rays[i], hits[i]);
+            }
+        });
+    }
+    else
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            Intersect(rays[i], hits[i]);
+        }
+    }
+}
+
+void TriangleBvh::IsOccluded(const Ray* rays, uint32_t count, bool* occluded, JobSystem* jobs) const
+{
+    if(jobs && count > kRayGrainSize)
+    {
+        jobs->ParallelFor(count, kRayGrainSize, [&](uint32_t begin, uint32_t end)
+        {
+            for(uint32_t i = begin; i < end; i++)
+            {
+                occluded[i] = IsOccluded(rays[i]);
+            }
+        });
+    }
+    else
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            occluded[i] = IsOccluded(rays[i]);
+        }
+    }
+}
+
+} // namespace CookieEngine
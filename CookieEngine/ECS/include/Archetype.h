@@ -0,0 +1,113 @@
+//
+//  Archetype.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Archetype_h
+#define CookieEngine_Archetype_h
+
+#include "Component.h"
+#include "Entity.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Size of a chunk, every chunk of every archetype is exactly this big
+static const uint32_t kChunkSize = 16 * 1024;
+
+// Component arrays inside a chunk start on this boundary so they can be
+// walked with aligned SSE/AVX loads
+static const uint32_t kComponentArrayAlignment = 32;
+
+class Archetype;
+class PoolAllocator;
+
+// Fixed size block holding up to capacity entities of a single archetype.
+// Layout of data: [Entity x capacity][A x capacity][B x capacity]...
+struct Chunk
+{
+    Archetype* archetype;
+    uint8_t* data;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+// All entities that have exactly the same set of components. Entities are
+// packed densely: every chunk except the last one is always full.
+class Archetype
+{
+private:
+    ComponentMask mMask;
+    uint32_t mCapacity;
+    uint32_t mComponentCount;
+    ComponentId mComponents[kMaxComponentTypes];
+    uint32_t mOffsets[kMaxComponentTypes];
+    std::vector<Chunk*> mChunks;
+    PoolAllocator& mChunkPool;
+    
+    Chunk* AllocateChunk();
+    void FreeChunk(Chunk* chunk);
+    
+public:
+    // Chunk memory comes from chunkPool, which MUST hand out kChunkSize blocks
+    Archetype(ComponentMask mask, PoolAllocator& chunkPool);
+    ~Archetype();
+    
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+    
+    __attribute__((always_inline)) ComponentMask GetMask() const { return mMask; }
+    
+    // Number of entities that fit in one chunk
+    __attribute__((always_inline)) uint32_t GetChunkCapacity() const { return mCapacity; }
+    
+    __attribute__((always_inline)) uint32_t GetComponentCount() const { return mComponentCount; }
+    __attribute__((always_inline)) ComponentId GetComponentId(uint32_t i) const { return mComponents[i]; }
+    
+    __attribute__((always_inline)) bool HasComponent(ComponentId id) const
+    {
+        return (mMask & (ComponentMask(1) << id)) != 0;
+    }
+    
+    __attribute__((always_inline)) size_t GetChunkCount() const { return mChunks.size(); }
+    __attribute__((always_inline)) Chunk* GetChunk(size_t i) const { return mChunks[i]; }
+    
+    // Returns the entity array of a chunk
+    __attribute__((always_inline)) Entity* GetEntities(const Chunk* chunk) const
+    {
+        return reinterpret_cast<Entity*>(chunk->data);
+    }
+    
+    // Returns the array of component id in chunk. id MUST be part of this archetype
+    __attribute__((always_inline)) void* GetComponentArray(const Chunk* chunk, ComponentId id) const
+    {
+        return chunk->data + mOffsets[id];
+    }
+    
+    // Returns a pointer to component id of the entity at index in chunk
+    __attribute__((always_inline)) void* GetComponent(const Chunk* chunk, uint32_t index, ComponentId id) const
+    {
+        return chunk->data + mOffsets[id] + (size_t)index * GetComponentInfo(id).size;
+    }
+    
+    // Total number of entities in this archetype
+    uint32_t GetEntityCount() const;
+    
+    // Reserves a slot at the end of the archetype and stores entity in it.
+    // The components of the slot are left unconstructed.
+    Chunk* AllocateSlot(Entity entity, uint32_t& index);
+    
+    // Frees the slot at index. Its components MUST already be destroyed.
+    // The last entity of the archetype is moved into the hole and returned,
+    // NullEntity is returned if nothing had to move.
+    Entity FreeSlot(Chunk* chunk, uint32_t index);
+};
+
+} // namespace CookieEngine
+
+#endif
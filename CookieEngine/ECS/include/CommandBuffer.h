@@ -0,0 +1,100 @@
+//
+//  CommandBuffer.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_CommandBuffer_h
+#define CookieEngine_CommandBuffer_h
+
+#include "Component.h"
+#include "Entity.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace CookieEngine
+{
+
+class World;
+
+// Records structural changes (create/destroy entities, add/remove components)
+// so they can be applied later when no Query is iterating. A CommandBuffer is
+// not thread safe, give every job thread its own and play them back in order.
+class CommandBuffer
+{
+private:
+    enum class CommandType : uint32_t
+    {
+        CreateEntity,
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent,
+    };
+    
+    struct CommandHeader
+    {
+        CommandType type;
+        ComponentId component;
+        Entity entity;
+        uint32_t payloadOffset;
+        uint32_t size;
+    };
+    
+    struct Block
+    {
+        uint8_t* data;
+        uint32_t used;
+        uint32_t capacity;
+    };
+    
+    std::vector<Block> mBlocks;
+    size_t mCurrentBlock;
+    uint32_t mPendingCount;
+    uint32_t mCommandCount;
+    
+    // Reserves space for a command with payloadSize bytes of payload aligned to payloadAlignment
+    CommandHeader* Push(CommandType type, Entity entity, ComponentId component,
+                        uint32_t payloadSize, uint32_t payloadAlignment);
+    
+    // Destroys unplayed payloads and rewinds all blocks
+    void Reset(bool destroyPayloads);
+    
+public:
+    CommandBuffer();
+    ~CommandBuffer();
+    
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    
+    // Records an entity creation. The returned handle is only valid as the
+    // target of other commands in this buffer.
+    Entity CreateEntity();
+    
+    void DestroyEntity(Entity entity);
+    
+    template<typename T>
+    void AddComponent(Entity entity, const T& value)
+    {
+        typedef typename std::remove_cv<T>::type Type;
+        const ComponentInfo& info = ComponentInfoOf<Type>();
+        CommandHeader* header = Push(CommandType::AddComponent, entity, info.id, info.size, info.alignment);
+        new(reinterpret_cast<uint8_t*>(header) + header->payloadOffset) Type(value);
+    }
+    
+    template<typename T>
+    void RemoveComponent(Entity entity)
+    {
+        Push(CommandType::RemoveComponent, entity, ComponentIdOf<T>(), 0, 1);
+    }
+    
+    __attribute__((always_inline)) bool IsEmpty() const { return mCommandCount == 0; }
+    
+    // Applies all commands to world in recording order and clears the buffer
+    void Playback(World& world);
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,108 @@
+//
+//  Component.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Component_h
+#define CookieEngine_Component_h
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CookieEngine
+{
+
+typedef uint32_t ComponentId;
+
+// One bit per registered component type
+typedef uint64_t ComponentMask;
+
+static const uint32_t kMaxComponentTypes = 64;
+
+// Type erased description of a component type. Chunks store components as raw
+// bytes, so these are used whenever a component is created, moved or destroyed.
+struct ComponentInfo
+{
+    ComponentId id;
+    uint32_t size;
+    uint32_t alignment;
+    void (*construct)(void* dst);
+    void (*moveConstruct)(void* dst, void* src);
+    void (*destroy)(void* ptr);
+};
+
+namespace Detail
+{
+    template<typename T>
+    struct ComponentOps
+    {
+        static void Construct(void* dst) { new(dst) T(); }
+        static void MoveConstruct(void* dst, void* src) { new(dst) T(std::move(*static_cast<T*>(src))); }
+        static void Destroy(void* ptr) { static_cast<T*>(ptr)->~T(); }
+    };
+    
+    // Assigns the next free id to info and stores it in the global table
+    ComponentId RegisterComponent(ComponentInfo info);
+    
+    template<typename T>
+    ComponentInfo MakeComponentInfo()
+    {
+        ComponentInfo info;
+        info.id = 0;
+        info.size = sizeof(T);
+        info.alignment = alignof(T);
+        info.construct = &ComponentOps<T>::Construct;
+        info.moveConstruct = &ComponentOps<T>::MoveConstruct;
+        info.destroy = &ComponentOps<T>::Destroy;
+        info.id = RegisterComponent(info);
+        return info;
+    }
+} // namespace Detail
+
+// Returns the info of a registered component id
+const ComponentInfo& GetComponentInfo(ComponentId id);
+
+// Returns the info of component type T, registering it on first use
+template<typename T>
+const ComponentInfo& ComponentInfoOf()
+{
+    typedef typename std::remove_cv<T>::type Type;
+    static const ComponentInfo info = Detail::MakeComponentInfo<Type>();
+    return info;
+}
+
+template<typename T>
+inline ComponentId ComponentIdOf()
+{
+    return ComponentInfoOf<typename std::remove_cv<T>::type>().id;
+}
+
+template<typename T>
+inline ComponentMask ComponentMaskOf()
+{
+    return ComponentMask(1) << ComponentIdOf<T>();
+}
+
+// Combined mask of a list of component types
+template<typename... Ts>
+struct ComponentMaskBuilder;
+
+template<>
+struct ComponentMaskBuilder<>
+{
+    static ComponentMask Get() { return 0; }
+};
+
+template<typename T, typename... Ts>
+struct ComponentMaskBuilder<T, Ts...>
+{
+    static ComponentMask Get() { return ComponentMaskOf<T>() | ComponentMaskBuilder<Ts...>::Get(); }
+};
+
+} // namespace CookieEngine
+
+#endif
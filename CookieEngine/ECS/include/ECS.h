@@ -0,0 +1,13 @@
+//
+//  ECS.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Entity.h"
+#include "Component.h"
+#include "Archetype.h"
+#include "World.h"
+#include "Query.h"
+#include "CommandBuffer.h"
@@ -0,0 +1,50 @@
+//
+//  Entity.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Entity_h
+#define CookieEngine_Entity_h
+
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+// Handle to an entity in a World. The generation is bumped every time an
+// index is recycled so stale handles can be detected.
+struct Entity
+{
+    uint32_t index;
+    uint32_t generation;
+    
+    __attribute__((always_inline)) bool operator==(const Entity& rhs) const
+    {
+        return index == rhs.index && generation == rhs.generation;
+    }
+    
+    __attribute__((always_inline)) bool operator!=(const Entity& rhs) const
+    {
+        return !(*this == rhs);
+    }
+    
+    // Returns false for the null entity
+    __attribute__((always_inline)) bool IsValid() const
+    {
+        return index != InvalidIndex;
+    }
+    
+    static const uint32_t InvalidIndex = 0xFFFFFFFF;
+    
+    // Index bit marking handles handed out by a CommandBuffer before playback
+    static const uint32_t PendingBit = 0x80000000;
+};
+
+// The null entity
+static const Entity NullEntity = { Entity::InvalidIndex, 0 };
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,168 @@
+//
+//  Query.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Query_h
+#define CookieEngine_Query_h
+
+#include "JobSystem.h"
+#include "World.h"
+
+#include <vector>
+
+namespace CookieEngine
+{
+
+namespace Detail
+{
+    template<typename Func, typename... Ts>
+    inline void RunEntityLoop(Func& func, uint32_t count, Ts*... arrays)
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            func(arrays[i]...);
+        }
+    }
+    
+    template<typename Func, typename... Ts>
+    inline void RunEntityLoopWithEntity(Func& func, const Entity* entities, uint32_t count, Ts*... arrays)
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            func(entities[i], arrays[i]...);
+        }
+    }
+} // namespace Detail
+
+// Iterates all entities that have at least the components Ts. Each matching
+// chunk is walked front to back, so component data is read linearly.
+// Mark component types const for read-only access, e.g. Query<Position, const Velocity>.
+template<typename... Ts>
+class Query
+{
+private:
+    World& mWorld;
+    ComponentMask mMask;
+    size_t mArchetypesSeen;
+    std::vector<Archetype*> mArchetypes;
+    std::vector<Chunk*> mChunks;
+    
+    // Picks up archetypes created since the last iteration
+    void Update()
+    {
+        for(; mArchetypesSeen < mWorld.GetArchetypeCount(); mArchetypesSeen++)
+        {
+            Archetype* archetype = mWorld.GetArchetype(mArchetypesSeen);
+            if((archetype->GetMask() & mMask) == mMask)
+            {
+                mArchetypes.push_back(archetype);
+            }
+        }
+    }
+    
+    template<typename Func>
+    __attribute__((always_inline)) static void RunChunk(Func& func, Chunk* chunk)
+    {
+        Archetype* archetype = chunk->archetype;
+        func(archetype->GetEntities(chunk), chunk->count,
+             static_cast<Ts*>(archetype->GetComponentArray(chunk, ComponentIdOf<Ts>()))...);
+    }
+    
+public:
+    explicit Query(World& world) : mWorld(world), mMask(ComponentMaskBuilder<Ts...>::Get()),
+                                   mArchetypesSeen(0), mArchetypes(), mChunks()
+    {
+    }
+    
+    // Calls func(const Entity* entities, uint32_t count, Ts*... arrays) for every matching chunk
+    template<typename Func>
+    void ForEachChunk(Func func)
+    {
+        Update();
+        for(size_t a = 0; a < mArchetypes.size(); a++)
+        {
+            Archetype* archetype = mArchetypes[a];
+            for(size_t c = 0; c < archetype->GetChunkCount(); c++)
+            {
+                RunChunk(func, archetype->GetChunk(c));
+            }
+        }
+    }
+    
+    // Calls func(Ts&... components) for every matching entity
+    template<typename Func>
+    void ForEach(Func func)
+    {
+        ForEachChunk([&func](const Entity*, uint32_t count, Ts*... arrays)
+        {
+            Detail::RunEntityLoop(func, count, arrays...);
+        });
+    }
+    
+    // Calls func(Entity entity, Ts&... components) for every matching entity
+    template<typename Func>
+    void ForEachEntity(Func func)
+    {
+        ForEachChunk([&func](const Entity* entities, uint32_t count, Ts*... arrays)
+        {
+            Detail::RunEntityLoopWithEntity(func, entities, count, arrays...);
+        });
+    }
+    
+    // Same as ForEachChunk but chunks are spread over the job threads.
+    // func is called concurrently and MUST NOT change the World, use one
+    // CommandBuffer per JobSystem::GetThreadIndex() for structural changes.
+    template<typename Func>
+    void ParallelForEachChunk(JobSystem& jobs, Func func)
+    {
+        Update();
+        
+        mChunks.clear();
+        for(size_t a = 0; a < mArchetypes.size(); a++)
+        {
+            Archetype* archetype = mArchetypes[a];
+            for(size_t c = 0; c < archetype->GetChunkCount(); c++)
+            {
+                mChunks.push_back(archetype->GetChunk(c));
+            }
+        }
+        
+        Chunk* const* chunks = mChunks.data();
+        jobs.ParallelFor((uint32_t)mChunks.size(), 1, [chunks, &func](uint32_t begin, uint32_t end)
+        {
+            for(uint32_t c = begin; c < end; c++)
+            {
+                RunChunk(func, chunks[c]);
+            }
+        });
+    }
+    
+    // Calls func(Ts&... components) for every matching entity on the job threads
+    template<typename Func>
+    void ParallelForEach(JobSystem& jobs, Func func)
+    {
+        ParallelForEachChunk(jobs, [&func](const Entity*, uint32_t count, Ts*... arrays)
+        {
+            Detail::RunEntityLoop(func, count, arrays...);
+        });
+    }
+    
+    // Number of entities matching the query
+    uint32_t GetEntityCount()
+    {
+        Update();
+        uint32_t count = 0;
+        for(size_t a = 0; a < mArchetypes.size(); a++)
+        {
+            count += mArchetypes[a]->GetEntityCount();
+        }
+        return count;
+    }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,139 @@
+//
+//  World.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_World_h
+#define CookieEngine_World_h
+
+#include "Archetype.h"
+#include "Component.h"
+#include "Entity.h"
+#include "PoolAllocator.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Owns all entities and their components. Components live in archetype
+// chunks, so adding or removing a component moves the entity to another
+// archetype. Structural changes MUST NOT happen while a Query is iterating,
+// record them in a CommandBuffer instead.
+class World
+{
+private:
+    struct EntityRecord
+    {
+        Chunk* chunk;
+        uint32_t index;
+        uint32_t generation;
+    };
+    
+    std::vector<EntityRecord> mRecords;
+    std::vector<uint32_t> mFreeIndices;
+    std::unordered_map<ComponentMask, Archetype*> mArchetypeMap;
+    std::vector<Archetype*> mArchetypes;
+    uint32_t mEntityCount;
+    PoolAllocator mChunkPool;
+    
+    // Moves the entity to the archetype with newMask. Components missing in
+    // the new archetype are destroyed, new ones are left unconstructed.
+    void MoveEntity(Entity entity, ComponentMask newMask);
+    
+    template<typename T>
+    static void ConstructFrom(void* dst, const T& value)
+    {
+        new(dst) typename std::remove_cv<T>::type(value);
+    }
+    
+    __attribute__((always_inline)) static void ConstructAll(Archetype*, Chunk*, uint32_t) {}
+    
+    template<typename T, typename... Ts>
+    static void ConstructAll(Archetype* archetype, Chunk* chunk, uint32_t index, const T& value, const Ts&... values)
+    {
+        ConstructFrom(archetype->GetComponent(chunk, index, ComponentIdOf<T>()), value);
+        ConstructAll(archetype, chunk, index, values...);
+    }
+    
+public:
+    World();
+    ~World();
+    
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    
+    // Creates an entity with default constructed components from mask
+    Entity CreateEntity(ComponentMask mask = 0);
+    
+    // Creates an entity with copies of the passed in components
+    template<typename T, typename... Ts>
+    Entity CreateEntity(const T& component, const Ts&... components)
+    {
+        Archetype* archetype = GetOrCreateArchetype(ComponentMaskBuilder<T, Ts...>::Get());
+        uint32_t index;
+        Chunk* chunk;
+        Entity entity = AllocateEntity(archetype, chunk, index);
+        ConstructAll(archetype, chunk, index, component, components...);
+        return entity;
+    }
+    
+    // Destroys entity and all of its components
+    void DestroyEntity(Entity entity);
+    
+    // Returns true if entity has not been destroyed
+    bool IsAlive(Entity entity) const;
+    
+    // Number of live entities
+    __attribute__((always_inline)) uint32_t GetEntityCount() const { return mEntityCount; }
+    
+    // Returns the component mask of entity
+    ComponentMask GetMask(Entity entity) const;
+    
+    // Adds component T to entity, replaces it if the entity already has one
+    template<typename T>
+    void AddComponent(Entity entity, const T& value)
+    {
+        typename std::remove_cv<T>::type copy(value);
+        AddComponentRaw(entity, ComponentIdOf<T>(), &copy);
+    }
+    
+    template<typename T>
+    void RemoveComponent(Entity entity)
+    {
+        RemoveComponentRaw(entity, ComponentIdOf<T>());
+    }
+    
+    template<typename T>
+    bool HasComponent(Entity entity) const
+    {
+        return (GetMask(entity) & ComponentMaskOf<T>()) != 0;
+    }
+    
+    // Returns component T of entity, nullptr if it has none
+    template<typename T>
+    T* GetComponent(Entity entity)
+    {
+        return static_cast<T*>(GetComponentRaw(entity, ComponentIdOf<T>()));
+    }
+    
+    // Type erased versions of the above. AddComponentRaw moves from value.
+    void AddComponentRaw(Entity entity, ComponentId id, void* value);
+    void RemoveComponentRaw(Entity entity, ComponentId id);
+    void* GetComponentRaw(Entity entity, ComponentId id);
+    
+    // Archetype access for queries
+    Archetype* GetOrCreateArchetype(ComponentMask mask);
+    __attribute__((always_inline)) size_t GetArchetypeCount() const { return mArchetypes.size(); }
+    __attribute__((always_inline)) Archetype* GetArchetype(size_t i) const { return mArchetypes[i]; }
+    
+    // Allocates an entity handle and a slot in archetype with unconstructed components
+    Entity AllocateEntity(Archetype* archetype, Chunk*& chunk, uint32_t& index);
+};
+
+} // namespace CookieEngine
+
+#endif
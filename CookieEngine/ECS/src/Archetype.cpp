@@ -0,0 +1,144 @@
+//
+//  Archetype.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Archetype.h"
+#include "PoolAllocator.h"
+
+#include <cassert>
+
+namespace CookieEngine
+{
+
+Chunk* Archetype::AllocateChunk()
+{
+    void* data = mChunkPool.Allocate();
+    assert(data != nullptr && "Out of memory");
+    
+    Chunk* chunk = new Chunk;
+    chunk->archetype = this;
+    chunk->data = static_cast<uint8_t*>(data);
+    chunk->count = 0;
+    chunk->capacity = mCapacity;
+    return chunk;
+}
+
+void Archetype::FreeChunk(Chunk* chunk)
+{
+    mChunkPool.Free(chunk->data);
+    delete chunk;
+}
+
+Archetype::Archetype(ComponentMask mask, PoolAllocator& chunkPool)
+    : mMask(mask), mCapacity(0), mComponentCount(0), mChunks(), mChunkPool(chunkPool)
+{
+    uint32_t bytesPerEntity = sizeof(Entity);
+    for(ComponentId id = 0; id < kMaxComponentTypes; id++)
+    {
+        mOffsets[id] = 0;
+        if(HasComponent(id))
+        {
+            const ComponentInfo& info = GetComponentInfo(id);
+            assert(info.alignment <= kComponentArrayAlignment && "Component alignment too large for chunk");
+            
+            mComponents[mComponentCount++] = id;
+            bytesPerEntity += info.size;
+        }
+    }
+    
+    // Start from the unpadded estimate and back off until the aligned layout fits
+    for(uint32_t capacity = kChunkSize / bytesPerEntity; capacity > 0; capacity--)
+    {
+        uint32_t offset = sizeof(Entity) * capacity;
+        for(uint32_t i = 0; i < mComponentCount; i++)
+        {
+            offset = (uint32_t)AlignUp(offset, kComponentArrayAlignment);
+            mOffsets[mComponents[i]] = offset;
+            offset += GetComponentInfo(mComponents[i]).size * capacity;
+        }
+        
+        if(offset <= kChunkSize)
+        {
+            mCapacity = capacity;
+            break;
+        }
+    }
+    
+    assert(mCapacity > 0 && "Archetype does not fit in a chunk");
+}
+
+Archetype::~Archetype()
+{
+    for(size_t c = 0; c < mChunks.size(); c++)
+    {
+        Chunk* chunk = mChunks[c];
+        for(uint32_t i = 0; i < mComponentCount; i++)
+        {
+            const ComponentInfo& info = GetComponentInfo(mComponents[i]);
+            uint8_t* array = static_cast<uint8_t*>(GetComponentArray(chunk, info.id));
+            for(uint32_t e = 0; e < chunk->count; e++)
+            {
+                info.destroy(array + (size_t)e * info.size);
+            }
+        }
+        FreeChunk(chunk);
+    }
+}
+
+uint32_t Archetype::GetEntityCount() const
+{
+    if(mChunks.empty())
+    {
+        return 0;
+    }
+    return (uint32_t)(mChunks.size() - 1) * mCapacity + mChunks.back()->count;
+}
+
+Chunk* Archetype::AllocateSlot(Entity entity, uint32_t& index)
+{
+    if(mChunks.empty() || mChunks.back()->count == mCapacity)
+    {
+        mChunks.push_back(AllocateChunk());
+    }
+    
+    Chunk* chunk = mChunks.back();
+    index = chunk->count++;
+    GetEntities(chunk)[index] = entity;
+    return chunk;
+}
+
+Entity Archetype::FreeSlot(Chunk* chunk, uint32_t index)
+{
+    Chunk* lastChunk = mChunks.back();
+    uint32_t lastIndex = lastChunk->count - 1;
+    Entity moved = NullEntity;
+    
+    if(chunk != lastChunk || index != lastIndex)
+    {
+        for(uint32_t i = 0; i < mComponentCount; i++)
+        {
+            const ComponentInfo& info = GetComponentInfo(mComponents[i]);
+            void* dst = GetComponent(chunk, index, info.id);
+            void* src = GetComponent(lastChunk, lastIndex, info.id);
+            info.moveConstruct(dst, src);
+            info.destroy(src);
+        }
+        
+        moved = GetEntities(lastChunk)[lastIndex];
+        GetEntities(chunk)[index] = moved;
+    }
+    
+    lastChunk->count--;
+    if(lastChunk->count == 0)
+    {
+        FreeChunk(lastChunk);
+        mChunks.pop_back();
+    }
+    
+    return moved;
+}
+
+} // namespace CookieEngine
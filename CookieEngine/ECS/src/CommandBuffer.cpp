@@ -0,0 +1,160 @@
+//
+//  CommandBuffer.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "CommandBuffer.h"
+#include "Allocator.h"
+#include "World.h"
+
+#include <cassert>
+
+namespace CookieEngine
+{
+
+static const uint32_t kCommandBlockSize = 16 * 1024;
+
+CommandBuffer::CommandBuffer() : mBlocks(), mCurrentBlock(0), mPendingCount(0), mCommandCount(0)
+{
+}
+
+CommandBuffer::~CommandBuffer()
+{
+    Reset(true);
+    for(size_t i = 0; i < mBlocks.size(); i++)
+    {
+        AlignedFree(mBlocks[i].data);
+    }
+}
+
+CommandBuffer::CommandHeader* CommandBuffer::Push(CommandType type, Entity entity, ComponentId component,
+                                                  uint32_t payloadSize, uint32_t payloadAlignment)
+{
+    // Commands are packed back to back, only the payload is padded to its alignment
+    while(mCurrentBlock < mBlocks.size())
+    {
+        Block& block = mBlocks[mCurrentBlock];
+        uint32_t payloadOffset = (uint32_t)AlignUp(block.used + sizeof(CommandHeader), payloadAlignment) - block.used;
+        if(block.used + AlignUp(payloadOffset + payloadSize, alignof(CommandHeader)) <= block.capacity)
+        {
+            break;
+        }
+        mCurrentBlock++;
+    }
+    
+    if(mCurrentBlock == mBlocks.size())
+    {
+        uint32_t worstCase = sizeof(CommandHeader) + payloadAlignment + payloadSize;
+        
+        Block block;
+        block.capacity = worstCase > kCommandBlockSize ? (uint32_t)AlignUp(worstCase, 64) : kCommandBlockSize;
+        block.used = 0;
+        block.data = static_cast<uint8_t*>(AlignedMalloc(block.capacity, 64));
+        assert(block.data != nullptr && "Out of memory");
+        mBlocks.push_back(block);
+    }
+    
+    Block& block = mBlocks[mCurrentBlock];
+    uint32_t payloadOffset = (uint32_t)AlignUp(block.used + sizeof(CommandHeader), payloadAlignment) - block.used;
+    
+    CommandHeader* header = reinterpret_cast<CommandHeader*>(block.data + block.used);
+    header->type = type;
+    header->component = component;
+    header->entity = entity;
+    header->payloadOffset = payloadOffset;
+    header->size = (uint32_t)AlignUp(payloadOffset + payloadSize, alignof(CommandHeader));
+    
+    block.used += header->size;
+    mCommandCount++;
+    return header;
+}
+
+Entity CommandBuffer::CreateEntity()
+{
+    Entity entity = { Entity::PendingBit | mPendingCount++, 0 };
+    Push(CommandType::CreateEntity, entity, 0, 0, 1);
+    return entity;
+}
+
+void CommandBuffer::DestroyEntity(Entity entity)
+{
+    Push(CommandType::DestroyEntity, entity, 0, 0, 1);
+}
+
+void CommandBuffer::Reset(bool destroyPayloads)
+{
+    for(size_t b = 0; b < mBlocks.size(); b++)
+    {
+        Block& block = mBlocks[b];
+        
+        if(destroyPayloads)
+        {
+            uint32_t offset = 0;
+            while(offset < block.used)
+            {
+                CommandHeader* header = reinterpret_cast<CommandHeader*>(block.data + offset);
+                if(header->type == CommandType::AddComponent)
+                {
+                    GetComponentInfo(header->component).destroy(reinterpret_cast<uint8_t*>(header) + header->payloadOffset);
+                }
+                offset += header->size;
+            }
+        }
+        
+        block.used = 0;
+    }
+    
+    mCurrentBlock = 0;
+    mPendingCount = 0;
+    mCommandCount = 0;
+}
+
+void CommandBuffer::Playback(World& world)
+{
+    std::vector<Entity> created;
+    created.reserve(mPendingCount);
+    
+    for(size_t b = 0; b < mBlocks.size(); b++)
+    {
+        Block& block = mBlocks[b];
+        uint32_t offset = 0;
+        while(offset < block.used)
+        {
+            CommandHeader* header = reinterpret_cast<CommandHeader*>(block.data + offset);
+            
+            Entity entity = header->entity;
+            if(entity.IsValid() && (entity.index & Entity::PendingBit) && header->type != CommandType::CreateEntity)
+            {
+                entity = created[entity.index & ~Entity::PendingBit];
+            }
+            
+            switch(header->type)
+            {
+                case CommandType::CreateEntity:
+                    created.push_back(world.CreateEntity());
+                    break;
+                case CommandType::DestroyEntity:
+                    world.DestroyEntity(entity);
+                    break;
+                case CommandType::AddComponent:
+                {
+                    void* payload = reinterpret_cast<uint8_t*>(header) + header->payloadOffset;
+                    world.AddComponentRaw(entity, header->component, payload);
+                    GetComponentInfo(header->component).destroy(payload);
+                    break;
+                }
+                case CommandType::RemoveComponent:
+                    world.RemoveComponentRaw(entity, header->component);
+                    break;
+            }
+            
+            offset += header->size;
+        }
+    }
+    
+    Reset(false);
+}
+
+} // namespace CookieEngine
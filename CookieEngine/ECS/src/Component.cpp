@@ -0,0 +1,36 @@
+//
+//  Component.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Component.h"
+
+#include <cassert>
+#include <mutex>
+
+namespace CookieEngine
+{
+
+static ComponentInfo sComponentTable[kMaxComponentTypes];
+static uint32_t sComponentCount = 0;
+static std::mutex sComponentMutex;
+
+ComponentId Detail::RegisterComponent(ComponentInfo info)
+{
+    std::lock_guard<std::mutex> lock(sComponentMutex);
+    assert(sComponentCount < kMaxComponentTypes && "Too many component types");
+    
+    info.id = sComponentCount;
+    sComponentTable[sComponentCount] = info;
+    return sComponentCount++;
+}
+
+const ComponentInfo& GetComponentInfo(ComponentId id)
+{
+    assert(id < kMaxComponentTypes);
+    return sComponentTable[id];
+}
+
+} // namespace CookieEngine
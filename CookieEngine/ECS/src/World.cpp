@@ -0,0 +1,222 @@
+//
+//  World.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "World.h"
+
+#include <cassert>
+
+namespace CookieEngine
+{
+
+World::World() : mRecords(), mFreeIndices(), mArchetypeMap(), mArchetypes(), mEntityCount(0),
+                 mChunkPool(kChunkSize, 64, 16, "ECS chunks")
+{
+}
+
+World::~World()
+{
+    for(size_t i = 0; i < mArchetypes.size(); i++)
+    {
+        delete mArchetypes[i];
+    }
+}
+
+Archetype* World::GetOrCreateArchetype(ComponentMask mask)
+{
+    std::unordered_map<ComponentMask, Archetype*>::iterator it = mArchetypeMap.find(mask);
+    if(it != mArchetypeMap.end())
+    {
+        return it->second;
+    }
+    
+    Archetype* archetype = new Archetype(mask, mChunkPool);
+    mArchetypeMap[mask] = archetype;
+    mArchetypes.push_back(archetype);
+    return archetype;
+}
+
+Entity World::AllocateEntity(Archetype* archetype, Chunk*& chunk, uint32_t& index)
+{
+    Entity entity;
+    if(!mFreeIndices.empty())
+    {
+        entity.index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = (uint32_t)mRecords.size();
+        assert((entity.index & Entity::PendingBit) == 0 && "Out of entity indices");
+        
+        EntityRecord record = { nullptr, 0, 0 };
+        mRecords.push_back(record);
+    }
+    
+    EntityRecord& record = mRecords[entity.index];
+    entity.generation = record.generation;
+    
+    chunk = archetype->AllocateSlot(entity, index);
+    record.chunk = chunk;
+    record.index = index;
+    
+    mEntityCount++;
+    return entity;
+}
+
+Entity World::CreateEntity(ComponentMask mask)
+{
+    Archetype* archetype = GetOrCreateArchetype(mask);
+    uint32_t index;
+    Chunk* chunk;
+    Entity entity = AllocateEntity(archetype, chunk, index);
+    
+    for(uint32_t i = 0; i < archetype->GetComponentCount(); i++)
+    {
+        ComponentId id = archetype->GetComponentId(i);
+        GetComponentInfo(id).construct(archetype->GetComponent(chunk, index, id));
+    }
+    
+    return entity;
+}
+
+bool World::IsAlive(Entity entity) const
+{
+    return entity.index < mRecords.size() &&
+           mRecords[entity.index].generation == entity.generation &&
+           mRecords[entity.index].chunk != nullptr;
+}
+
+ComponentMask World::GetMask(Entity entity) const
+{
+    if(!IsAlive(entity))
+    {
+        return 0;
+    }
+    return mRecords[entity.index].chunk->archetype->GetMask();
+}
+
+void World::DestroyEntity(Entity entity)
+{
+    if(!IsAlive(entity))
+    {
+        return;
+    }
+    
+    EntityRecord& record = mRecords[entity.index];
+    Chunk* chunk = record.chunk;
+    Archetype* archetype = chunk->archetype;
+    
+    for(uint32_t i = 0; i < archetype->GetComponentCount(); i++)
+    {
+        ComponentId id = archetype->GetComponentId(i);
+        GetComponentInfo(id).destroy(archetype->GetComponent(chunk, record.index, id));
+    }
+    
+    Entity moved = archetype->FreeSlot(chunk, record.index);
+    if(moved.IsValid())
+    {
+        mRecords[moved.index].chunk = chunk;
+        mRecords[moved.index].index = record.index;
+    }
+    
+    record.chunk = nullptr;
+    record.generation++;
+    mFreeIndices.push_back(entity.index);
+    mEntityCount--;
+}
+
+void World::MoveEntity(Entity entity, ComponentMask newMask)
+{
+    EntityRecord& record = mRecords[entity.index];
+    Chunk* srcChunk = record.chunk;
+    Archetype* src = srcChunk->archetype;
+    uint32_t srcIndex = record.index;
+    
+    Archetype* dst = GetOrCreateArchetype(newMask);
+    uint32_t dstIndex;
+    Chunk* dstChunk = dst->AllocateSlot(entity, dstIndex);
+    
+    for(uint32_t i = 0; i < src->GetComponentCount(); i++)
+    {
+        ComponentId id = src->GetComponentId(i);
+        const ComponentInfo& info = GetComponentInfo(id);
+        void* srcComponent = src->GetComponent(srcChunk, srcIndex, id);
+        
+        if(dst->HasComponent(id))
+        {
+            info.moveConstruct(dst->GetComponent(dstChunk, dstIndex, id), srcComponent);
+        }
+        info.destroy(srcComponent);
+    }
+    
+    Entity moved = src->FreeSlot(srcChunk, srcIndex);
+    if(moved.IsValid())
+    {
+        mRecords[moved.index].chunk = srcChunk;
+        mRecords[moved.index].index = srcIndex;
+    }
+    
+    record.chunk = dstChunk;
+    record.index = dstIndex;
+}
+
+void World::AddComponentRaw(Entity entity, ComponentId id, void* value)
+{
+    if(!IsAlive(entity))
+    {
+        return;
+    }
+    
+    const ComponentInfo& info = GetComponentInfo(id);
+    EntityRecord& record = mRecords[entity.index];
+    Archetype* archetype = record.chunk->archetype;
+    
+    if(archetype->HasComponent(id))
+    {
+        void* component = archetype->GetComponent(record.chunk, record.index, id);
+        info.destroy(component);
+        info.moveConstruct(component, value);
+        return;
+    }
+    
+    MoveEntity(entity, archetype->GetMask() | (ComponentMask(1) << id));
+    
+    Archetype* newArchetype = record.chunk->archetype;
+    info.moveConstruct(newArchetype->GetComponent(record.chunk, record.index, id), value);
+}
+
+void World::RemoveComponentRaw(Entity entity, ComponentId id)
+{
+    if(!IsAlive(entity))
+    {
+        return;
+    }
+    
+    ComponentMask mask = mRecords[entity.index].chunk->archetype->GetMask();
+    if(mask & (ComponentMask(1) << id))
+    {
+        MoveEntity(entity, mask & ~(ComponentMask(1) << id));
+    }
+}
+
+void* World::GetComponentRaw(Entity entity, ComponentId id)
+{
+    if(!IsAlive(entity))
+    {
+        return nullptr;
+    }
+    
+    EntityRecord& record = mRecords[entity.index];
+    Archetype* archetype = record.chunk->archetype;
+    if(!archetype->HasComponent(id))
+    {
+        return nullptr;
+    }
+    return archetype->GetComponent(record.chunk, record.index, id);
+}
+
+} // namespace CookieEngine
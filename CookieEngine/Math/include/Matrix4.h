@@ -12,13 +12,15 @@
 #include <smmintrin.h>
 #include <cmath>
 
+#include "MatrixExpression.h"
+
 namespace CookieEngine
 {
 // Forward declaration to avoid circular dependency
 class Vector3;
 
 // 4x4 Matrix class using SSE4.1
-class Matrix4
+class Matrix4 : public MatrixExpression<Matrix4>
 {
 private:
     __m128 mRows[4];
@@ -28,6 +30,26 @@ public:
     // Default constructor does nothing
     __attribute__((always_inline)) Matrix4() {}
     
+    // Constructs a matrix from its elements in row-major order. constexpr, so
+    // constants built with it need no dynamic initialization.
+    __attribute__((always_inline)) constexpr Matrix4(float m00, float m01, float m02, float m03,
+                                                     float m10, float m11, float m12, float m13,
+                                                     float m20, float m21, float m22, float m23,
+                                                     float m30, float m31, float m32, float m33)
+        : mRows{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } }
+    {
+    }
+    
+    // Evaluates a matrix expression such as a * s + b, one row at a time
+    template<typename E>
+    __attribute__((always_inline)) Matrix4(const MatrixExpression<E>& expression)
+    {
+        mRows[0] = expression.GetRow(0);
+        mRows[1] = expression.GetRow(1);
+        mRows[2] = expression.GetRow(2);
+        mRows[3] = expression.GetRow(3);
+    }
+    
     // Contruct a 4x4 Matrix from the passed in float array
     __attribute__((always_inline)) Matrix4(float mat[4][4])
     {
@@ -64,28 +86,87 @@ public:
         return *this;
     }
     
+    // Evaluates a matrix expression into this matrix. Row i of the expression
+    // may only read row i of this matrix, which holds for all componentwise operators.
+    template<typename E>
+    __attribute__((always_inline)) Matrix4& operator=(const MatrixExpression<E>& expression)
+    {
+        mRows[0] = expression.GetRow(0);
+        mRows[1] = expression.GetRow(1);
+        mRows[2] = expression.GetRow(2);
+        mRows[3] = expression.GetRow(3);
+        return *this;
+    }
+    
+    template<typename E>
+    __attribute__((always_inline)) Matrix4& operator+=(const MatrixExpression<E>& expression)
+    {
+        return *this = *this + expression;
+    }
+    
+    template<typename E>
+    __attribute__((always_inline)) Matrix4& operator-=(const MatrixExpression<E>& expression)
+    {
+        return *this = *this - expression;
+    }
+    
+    __attribute__((always_inline)) Matrix4& operator*=(float scale)
+    {
+        return *this = *this * scale;
+    }
+    
+    __attribute__((always_inline)) Matrix4& operator*=(const Matrix4& rhs)
+    {
+        return *this = Concatenate(*this, rhs);
+    }
+    
+    // Copies the matrix into out in row-major order
+    __attribute__((always_inline)) void Store(float out[16]) const
+    {
+        _mm_storeu_ps(out + 0, mRows[0]);
+        _mm_storeu_ps(out + 4, mRows[1]);
+        _mm_storeu_ps(out + 8, mRows[2]);
+        _mm_storeu_ps(out + 12, mRows[3]);
+    }
+    
+    // Returns row i (0-3) of the matrix
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return mRows[i];
+    }
+    
+    // Sets row i (0-3) of the matrix
+    __attribute__((always_inline)) void SetRow(int i, __m128 row)
+    {
+        mRows[i] = row;
+    }
+    
     // Multiplies this Matrix by the rhs matrix
-    void Multiply(const Matrix4& rhs)
+    __attribute__((always_inline)) void Multiply(const Matrix4& rhs)
     {
-        __m128 rhs_row0 = rhs.mRows[0];
-        __m128 rhs_row1 = rhs.mRows[1];
-        __m128 rhs_row2 = rhs.mRows[2];
-        __m128 rhs_row3 = rhs.mRows[3];
-        
-        // transpose the rhs matrix
-        _MM_TRANSPOSE4_PS(rhs_row0, rhs_row1, rhs_row2, rhs_row3);
-        
-        for(int i = 0; i < 4; i++)
-        {
-            __m128 x = _mm_dp_ps(mRows[i], rhs_row0, 0xF8);
-            __m128 y = _mm_dp_ps(mRows[i], rhs_row1, 0xF8);
-            __m128 z = _mm_dp_ps(mRows[i], rhs_row2, 0xF8);
-            __m128 w = _mm_dp_ps(mRows[i], rhs_row3, 0xF8);
-            mRows[i] = _mm_insert_ps(mRows[i], x, 0xC0);
-            mRows[i] = _mm_insert_ps(mRows[i], y, 0xD0);
-            mRows[i] = _mm_insert_ps(mRows[i], z, 0xE0);
-            mRows[i] = _mm_insert_ps(mRows[i], w, 0xF0);
-        }
+        *this = Concatenate(*this, rhs);
+    }
+    
+    // Returns row * rhs, one row of a matrix product. The result is a linear
+    // combination of the rhs rows, which needs no transpose and no horizontal dot products.
+    __attribute__((always_inline)) static __m128 ConcatenateRow(__m128 row, const Matrix4& rhs)
+    {
+        __m128 sum = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), rhs.mRows[0]);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), rhs.mRows[1]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), rhs.mRows[2]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), rhs.mRows[3]));
+        return sum;
+    }
+    
+    // Returns lhs * rhs
+    __attribute__((always_inline)) friend Matrix4 Concatenate(const Matrix4& lhs, const Matrix4& rhs)
+    {
+        Matrix4 result;
+        result.mRows[0] = ConcatenateRow(lhs.mRows[0], rhs);
+        result.mRows[1] = ConcatenateRow(lhs.mRows[1], rhs);
+        result.mRows[2] = ConcatenateRow(lhs.mRows[2], rhs);
+        result.mRows[3] = ConcatenateRow(lhs.mRows[3], rhs);
+        return result;
     }
     
     // Transpose this Matrix
@@ -179,25 +260,8 @@ public:
         mRows[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
     }
     
-    __attribute__((always_inline)) friend Matrix4 Lerp(const Matrix4& a, const Matrix4& b, float f)
-    {
-        Matrix4 result;
-        
-        __m128 rhsF = _mm_set_ps1(f);
-        __m128 lhsF = _mm_set_ps1(1.0f);
-        lhsF = _mm_sub_ps(lhsF, rhsF);
-        
-        result.mRows[0] = _mm_mul_ps(a.mRows[0], lhsF);
-        result.mRows[0] = _mm_add_ps(result.mRows[0], _mm_mul_ps(b.mRows[0], rhsF));
-        result.mRows[1] = _mm_mul_ps(a.mRows[1], lhsF);
-        result.mRows[1] = _mm_add_ps(result.mRows[1], _mm_mul_ps(b.mRows[1], rhsF));
-        result.mRows[2] = _mm_mul_ps(a.mRows[2], lhsF);
-        result.mRows[2] = _mm_add_ps(result.mRows[2], _mm_mul_ps(b.mRows[2], rhsF));
-        result.mRows[3] = _mm_mul_ps(a.mRows[3], lhsF);
-        result.mRows[3] = _mm_add_ps(result.mRows[3], _mm_mul_ps(b.mRows[3], rhsF));
-        
-        return result;
-    }
+    // Inverts this matrix, returns false and leaves it untouched if it is singular
+    bool Invert();
     
     // Given translation vector, construct a translation matrix
     void CreateTranslation(const Vector3& translation);
@@ -213,6 +277,19 @@ public:
     static const Matrix4 Identity;
 } __attribute__ ((aligned (16)));
 
+// Matrix product. lhs may be an expression, it is evaluated row by row
+// straight into the result. Wrap an rhs expression in Matrix4() first.
+template<typename L>
+inline Matrix4 operator*(const MatrixExpression<L>& lhs, const Matrix4& rhs)
+{
+    Matrix4 result;
+    result.SetRow(0, Matrix4::ConcatenateRow(lhs.GetRow(0), rhs));
+    result.SetRow(1, Matrix4::ConcatenateRow(lhs.GetRow(1), rhs));
+    result.SetRow(2, Matrix4::ConcatenateRow(lhs.GetRow(2), rhs));
+    result.SetRow(3, Matrix4::ConcatenateRow(lhs.GetRow(3), rhs));
+    return result;
+}
+
 } // namespace CookieEngine
 
 #endif
@@ -0,0 +1,157 @@
+//
+//  MatrixExpression.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_MatrixExpression_h
+#define CookieEngine_MatrixExpression_h
+
+#include <smmintrin.h>
+
+namespace CookieEngine
+{
+
+class Matrix4;
+
+// Base of the lazy matrix expressions. Componentwise operators on matrices
+// build a tree of these instead of computing a Matrix4 per operator, and the
+// tree is evaluated one row at a time when it is assigned to a Matrix4. So
+// m = a * s + b * t - c loads each row of a, b and c once and stores each
+// row of m once, with no temporary matrices in between.
+//
+// Expressions keep references to the Matrix4 operands. Assign them to a
+// Matrix4 right away, never keep one in an auto variable.
+template<typename E>
+class MatrixExpression
+{
+public:
+    // Evaluates row i of the expression
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return static_cast<const E&>(*this).GetRow(i);
+    }
+};
+
+namespace Detail
+{
+    // Matrices are held by reference, sub expressions are small and held by value
+    template<typename E>
+    struct ExpressionOperand
+    {
+        typedef const E Type;
+    };
+    
+    template<>
+    struct ExpressionOperand<Matrix4>
+    {
+        typedef const Matrix4& Type;
+    };
+} // namespace Detail
+
+// lhs + rhs
+template<typename L, typename R>
+class MatrixSum : public MatrixExpression<MatrixSum<L, R> >
+{
+private:
+    typename Detail::ExpressionOperand<L>::Type mLhs;
+    typename Detail::ExpressionOperand<R>::Type mRhs;
+    
+public:
+    __attribute__((always_inline)) MatrixSum(const L& lhs, const R& rhs) : mLhs(lhs), mRhs(rhs) {}
+    
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return _mm_add_ps(mLhs.GetRow(i), mRhs.GetRow(i));
+    }
+};
+
+// lhs - rhs
+template<typename L, typename R>
+class MatrixDifference : public MatrixExpression<MatrixDifference<L, R> >
+{
+private:
+    typename Detail::ExpressionOperand<L>::Type mLhs;
+    typename Detail::ExpressionOperand<R>::Type mRhs;
+    
+public:
+    __attribute__((always_inline)) MatrixDifference(const L& lhs, const R& rhs) : mLhs(lhs), mRhs(rhs) {}
+    
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return _mm_sub_ps(mLhs.GetRow(i), mRhs.GetRow(i));
+    }
+};
+
+// expression * scalar
+template<typename E>
+class MatrixScale : public MatrixExpression<MatrixScale<E> >
+{
+private:
+    typename Detail::ExpressionOperand<E>::Type mExpression;
+    __m128 mScale;
+    
+public:
+    __attribute__((always_inline)) MatrixScale(const E& expression, float scale)
+        : mExpression(expression), mScale(_mm_set_ps1(scale)) {}
+    
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return _mm_mul_ps(mExpression.GetRow(i), mScale);
+    }
+};
+
+// a * (1 - f) + b * f
+template<typename A, typename B>
+class MatrixLerp : public MatrixExpression<MatrixLerp<A, B> >
+{
+private:
+    typename Detail::ExpressionOperand<A>::Type mA;
+    typename Detail::ExpressionOperand<B>::Type mB;
+    __m128 mFactorA;
+    __m128 mFactorB;
+    
+public:
+    __attribute__((always_inline)) MatrixLerp(const A& a, const B& b, float f)
+        : mA(a), mB(b), mFactorA(_mm_set_ps1(1.0f - f)), mFactorB(_mm_set_ps1(f)) {}
+    
+    __attribute__((always_inline)) __m128 GetRow(int i) const
+    {
+        return _mm_add_ps(_mm_mul_ps(mA.GetRow(i), mFactorA), _mm_mul_ps(mB.GetRow(i), mFactorB));
+    }
+};
+
+template<typename L, typename R>
+inline MatrixSum<L, R> operator+(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
+{
+    return MatrixSum<L, R>(static_cast<const L&>(lhs), static_cast<const R&>(rhs));
+}
+
+template<typename L, typename R>
+inline MatrixDifference<L, R> operator-(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
+{
+    return MatrixDifference<L, R>(static_cast<const L&>(lhs), static_cast<const R&>(rhs));
+}
+
+template<typename E>
+inline MatrixScale<E> operator*(const MatrixExpression<E>& expression, float scale)
+{
+    return MatrixScale<E>(static_cast<const E&>(expression), scale);
+}
+
+template<typename E>
+inline MatrixScale<E> operator*(float scale, const MatrixExpression<E>& expression)
+{
+    return MatrixScale<E>(static_cast<const E&>(expression), scale);
+}
+
+template<typename A, typename B>
+inline MatrixLerp<A, B> Lerp(const MatrixExpression<A>& a, const MatrixExpression<B>& b, float f)
+{
+    return MatrixLerp<A, B>(static_cast<const A&>(a), static_cast<const B&>(b), f);
+}
+
+} // namespace CookieEngine
+
+#endif
@@ -28,21 +28,27 @@ public:
     
     // Constructs a vector given passed x, y, and z components
     // w is set to 1.0f
-    __attribute__((always_inline)) Vector3(float x, float y, float z)
+    __attribute__((always_inline)) constexpr Vector3(float x, float y, float z)
+        : mData{ x, y, z, 1.0f }
+    {
+    }
+    
+    // Constructs a vector given all four components
+    __attribute__((always_inline)) constexpr Vector3(float x, float y, float z, float w)
+        : mData{ x, y, z, w }
     {
-        mData = _mm_setr_ps(x, y, z, 1.0f);
     }
     
     // Constructs a vector given an __m128
-    __attribute__((always_inline)) Vector3(__m128 value)
+    __attribute__((always_inline)) constexpr Vector3(__m128 value)
+        : mData(value)
     {
-        mData = value;
     }
     
     // Copy constructor
-    __attribute__((always_inline)) Vector3(const Vector3& rhs)
+    __attribute__((always_inline)) constexpr Vector3(const Vector3& rhs)
+        : mData(rhs.mData)
     {
-        mData = rhs.mData;
     }
     
     // Assignment operator
@@ -114,7 +120,7 @@ public:
     // Calculates the dot product of this vector and rhs
     __attribute__((always_inline)) float Dot(const Vector3& rhs) const
     {
-        return _mm_dp_ps(mData, rhs.mData, 0.7F)[0];
+        return _mm_cvtss_f32(_mm_dp_ps(mData, rhs.mData, 0x71));
     }
     
     // Does a componentwise addition with rhs and stores in this
@@ -136,6 +142,52 @@ public:
         mData = _mm_mul_ps(mData, temp);
     }
     
+    // Componentwise operators returning new vectors. Everything is inlined and
+    // lives in registers, so chains like a * s + b * t - c compile to one
+    // sequence of SSE ops with no stores in between.
+    __attribute__((always_inline)) friend Vector3 operator+(const Vector3& lhs, const Vector3& rhs)
+    {
+        return _mm_add_ps(lhs.mData, rhs.mData);
+    }
+    
+    __attribute__((always_inline)) friend Vector3 operator-(const Vector3& lhs, const Vector3& rhs)
+    {
+        return _mm_sub_ps(lhs.mData, rhs.mData);
+    }
+    
+    __attribute__((always_inline)) friend Vector3 operator-(const Vector3& value)
+    {
+        return _mm_xor_ps(value.mData, _mm_set_ps1(-0.0f));
+    }
+    
+    __attribute__((always_inline)) friend Vector3 operator*(const Vector3& lhs, float scalar)
+    {
+        return _mm_mul_ps(lhs.mData, _mm_set_ps1(scalar));
+    }
+    
+    __attribute__((always_inline)) friend Vector3 operator*(float scalar, const Vector3& rhs)
+    {
+        return _mm_mul_ps(rhs.mData, _mm_set_ps1(scalar));
+    }
+    
+    __attribute__((always_inline)) Vector3& operator+=(const Vector3& rhs)
+    {
+        mData = _mm_add_ps(mData, rhs.mData);
+        return *this;
+    }
+    
+    __attribute__((always_inline)) Vector3& operator-=(const Vector3& rhs)
+    {
+        mData = _mm_sub_ps(mData, rhs.mData);
+        return *this;
+    }
+    
+    __attribute__((always_inline)) Vector3& operator*=(float scalar)
+    {
+        mData = _mm_mul_ps(mData, _mm_set_ps1(scalar));
+        return *this;
+    }
+    
     // Normalizes this vector
     __attribute__((always_inline)) void Normalize()
     {
@@ -215,6 +267,9 @@ public:
     // Transform as Vector (multiply by transform matrix & set w to 0f)
     void TransformAsVector(const Matrix4& mat);
     
+    // Returns the point rhs transformed by lhs, the value returning form of Transform
+    friend Vector3 operator*(const Matrix4& lhs, const Vector3& rhs);
+    
     // TODO: Rotate (multiply by quaternion)
     friend class Matrix4;
     
@@ -26,38 +26,34 @@ const Vector3 Vector3::Forward(0.0f, 0.0f, 1.0f);
     
 void Vector3::Transform(const Matrix4& mat)
 {
+    // Every dot product reads the original vector, results are merged at the end
     __m128 temp = _mm_set_ss(1.0f);
-    mData = _mm_insert_ps(mData, temp, 0x30);
+    __m128 vec = _mm_insert_ps(mData, temp, 0x30);
     
-    temp = _mm_dp_ps(mat.mRows[0], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xC0);
-    
-    temp = _mm_dp_ps(mat.mRows[1], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xD0);
-    
-    temp = _mm_dp_ps(mat.mRows[2], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xE0);
-    
-    temp = _mm_dp_ps(mat.mRows[3], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xF0);
+    __m128 x = _mm_dp_ps(mat.mRows[0], vec, 0xF1);
+    __m128 y = _mm_dp_ps(mat.mRows[1], vec, 0xF2);
+    __m128 z = _mm_dp_ps(mat.mRows[2], vec, 0xF4);
+    __m128 w = _mm_dp_ps(mat.mRows[3], vec, 0xF8);
+    mData = _mm_or_ps(_mm_or_ps(x, y), _mm_or_ps(z, w));
 }
     
 void Vector3::TransformAsVector(const Matrix4& mat)
 {
     __m128 temp = _mm_set_ss(0.0f);
-    mData = _mm_insert_ps(mData, temp, 0x30);
-    
-    temp = _mm_dp_ps(mat.mRows[0], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xC0);
+    __m128 vec = _mm_insert_ps(mData, temp, 0x30);
     
-    temp = _mm_dp_ps(mat.mRows[1], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xD0);
-    
-    temp = _mm_dp_ps(mat.mRows[2], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xE0);
+    __m128 x = _mm_dp_ps(mat.mRows[0], vec, 0xF1);
+    __m128 y = _mm_dp_ps(mat.mRows[1], vec, 0xF2);
+    __m128 z = _mm_dp_ps(mat.mRows[2], vec, 0xF4);
+    __m128 w = _mm_dp_ps(mat.mRows[3], vec, 0xF8);
+    mData = _mm_or_ps(_mm_or_ps(x, y), _mm_or_ps(z, w));
+}
     
-    temp = _mm_dp_ps(mat.mRows[3], mData, 0xF8);
-    mData = _mm_insert_ps(mData, temp, 0xF0);
+Vector3 operator*(const Matrix4& lhs, const Vector3& rhs)
+{
+    Vector3 result(rhs);
+    result.Transform(lhs);
+    return result;
 }
     
 } // namespace CookieEngine
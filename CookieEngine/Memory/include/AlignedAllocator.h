@@ -0,0 +1,68 @@
+//
+//  AlignedAllocator.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_AlignedAllocator_h
+#define CookieEngine_AlignedAllocator_h
+
+#include "Allocator.h"
+
+#include <new>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// STL allocator that aligns storage to at least Alignment bytes. Before C++17
+// std::allocator ignores over-alignment, so std::vector<Vector3> can hand out
+// misaligned elements. Use AlignedVector for containers of SIMD types.
+template<typename T, size_t Alignment = (alignof(T) > kSimdAlignment ? alignof(T) : kSimdAlignment)>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+    
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    
+    AlignedAllocator() {}
+    
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+    
+    T* allocate(size_t count)
+    {
+        void* ptr = AlignedMalloc(sizeof(T) * count, Alignment);
+        if(!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+    
+    void deallocate(T* ptr, size_t)
+    {
+        AlignedFree(ptr);
+    }
+    
+    template<typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+};
+
+template<typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; }
+
+template<typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; }
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,98 @@
+//
+//  Allocator.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Allocator_h
+#define CookieEngine_Allocator_h
+
+#include <cstddef>
+#include <cstdint>
+
+// Debug mode adds guard bytes behind every allocation, fills fresh and freed
+// memory with patterns and reports leaks, overruns and double frees.
+// On by default in debug builds, define COOKIE_MEMORY_DEBUG to 0 or 1 to override.
+#ifndef COOKIE_MEMORY_DEBUG
+#ifdef NDEBUG
+#define COOKIE_MEMORY_DEBUG 0
+#else
+#define COOKIE_MEMORY_DEBUG 1
+#endif
+#endif
+
+namespace CookieEngine
+{
+
+// Alignment of the SIMD math types (Vector3, Matrix4)
+static const size_t kSimdAlignment = 16;
+
+// Alignment that also satisfies AVX loads
+static const size_t kAvxAlignment = 32;
+
+__attribute__((always_inline)) inline size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+__attribute__((always_inline)) inline bool IsAligned(const void* ptr, size_t alignment)
+{
+    return ((uintptr_t)ptr & (alignment - 1)) == 0;
+}
+
+// Allocates size bytes aligned to alignment (power of two), nullptr on failure
+void* AlignedMalloc(size_t size, size_t alignment);
+
+// Frees memory returned by AlignedMalloc
+void AlignedFree(void* ptr);
+
+// Allocation counters kept by every allocator
+struct AllocatorStats
+{
+    size_t liveAllocations;
+    size_t liveBytes;
+    size_t peakBytes;
+    size_t totalAllocations;
+    size_t reservedBytes;
+    
+    AllocatorStats() : liveAllocations(0), liveBytes(0), peakBytes(0), totalAllocations(0), reservedBytes(0) {}
+    
+    __attribute__((always_inline)) void OnAllocate(size_t size)
+    {
+        liveAllocations++;
+        totalAllocations++;
+        liveBytes += size;
+        if(liveBytes > peakBytes)
+        {
+            peakBytes = liveBytes;
+        }
+    }
+    
+    __attribute__((always_inline)) void OnFree(size_t size)
+    {
+        liveAllocations--;
+        liveBytes -= size;
+    }
+};
+
+namespace Detail
+{
+    // Fill patterns used in debug mode
+    static const uint8_t kGuardByte = 0xFD;
+    static const uint8_t kAllocatedByte = 0xCD;
+    static const uint8_t kFreedByte = 0xDD;
+    
+    // Bytes of guard placed behind every allocation in debug mode
+    static const size_t kGuardSize = 16;
+    
+    void WriteGuard(void* guard);
+    bool CheckGuard(const void* guard);
+    
+    // Prints a memory error for allocator name and breaks in debug builds
+    void ReportMemoryError(const char* name, const char* message, const void* ptr);
+} // namespace Detail
+
+} // namespace CookieEngine
+
+#endif
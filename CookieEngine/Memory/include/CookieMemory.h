@@ -0,0 +1,11 @@
+//
+//  CookieMemory.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Allocator.h"
+#include "AlignedAllocator.h"
+#include "LinearAllocator.h"
+#include "PoolAllocator.h"
@@ -0,0 +1,201 @@
+//
+//  LinearAllocator.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_LinearAllocator_h
+#define CookieEngine_LinearAllocator_h
+
+#include "Allocator.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Bump allocator over a single fixed buffer. Allocations are freed all at
+// once with Reset or back to a Marker with Rewind. Not thread safe, give
+// every thread its own.
+class LinearAllocator
+{
+private:
+    const char* mName;
+    uint8_t* mBuffer;
+    size_t mCapacity;
+    size_t mOffset;
+    AllocatorStats mStats;
+#if COOKIE_MEMORY_DEBUG
+    std::vector<size_t> mGuards;
+    
+    void CheckGuards(size_t fromOffset);
+#endif
+    
+public:
+    // Position in the arena returned by GetMarker
+    struct Marker
+    {
+        size_t offset;
+        size_t liveAllocations;
+        size_t liveBytes;
+    };
+    
+    // Reserves capacity bytes up front
+    explicit LinearAllocator(size_t capacity, const char* name = "LinearAllocator");
+    ~LinearAllocator();
+    
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+    
+    // Returns size bytes aligned to alignment, nullptr if the buffer is full
+    __attribute__((always_inline)) void* Allocate(size_t size, size_t alignment = kSimdAlignment)
+    {
+        size_t offset = AlignUp((size_t)(mBuffer + mOffset), alignment) - (size_t)mBuffer;
+        size_t end = offset + size;
+#if COOKIE_MEMORY_DEBUG
+        end += Detail::kGuardSize;
+#endif
+        if(end > mCapacity)
+        {
+            return nullptr;
+        }
+        
+#if COOKIE_MEMORY_DEBUG
+        Detail::WriteGuard(mBuffer + offset + size);
+        mGuards.push_back(offset + size);
+#endif
+        mOffset = end;
+        mStats.OnAllocate(size);
+        return mBuffer + offset;
+    }
+    
+    // Allocates and constructs a T. Destructors are never run, so T MUST be trivially destructible
+    template<typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "LinearAllocator never runs destructors");
+        void* ptr = Allocate(sizeof(T), alignof(T) > kSimdAlignment ? alignof(T) : kSimdAlignment);
+        return ptr ? new(ptr) T(std::forward<Args>(args)...) : nullptr;
+    }
+    
+    // Allocates an uninitialized array of count T
+    template<typename T>
+    T* NewArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "LinearAllocator never runs destructors");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T) > kSimdAlignment ? alignof(T) : kSimdAlignment));
+    }
+    
+    // Returns the current position, pass to Rewind to free everything allocated after it
+    __attribute__((always_inline)) Marker GetMarker() const
+    {
+        Marker marker = { mOffset, mStats.liveAllocations, mStats.liveBytes };
+        return marker;
+    }
+    
+    // Frees all allocations made after marker
+    void Rewind(Marker marker);
+    
+    // Frees all allocations
+    __attribute__((always_inline)) void Reset()
+    {
+        Marker start = { 0, 0, 0 };
+        Rewind(start);
+    }
+    
+    __attribute__((always_inline)) size_t GetCapacity() const { return mCapacity; }
+    __attribute__((always_inline)) size_t GetUsed() const { return mOffset; }
+    __attribute__((always_inline)) const AllocatorStats& GetStats() const { return mStats; }
+};
+
+// Per-frame scratch memory. Two linear arenas are swapped every BeginFrame,
+// so anything allocated during frame N stays valid until BeginFrame of N+2.
+// That is long enough for the render thread to consume data produced by the
+// previous simulation step.
+class FrameAllocator
+{
+private:
+    LinearAllocator mEvenArena;
+    LinearAllocator mOddArena;
+    LinearAllocator* mArenas[2];
+    uint32_t mCurrent;
+    size_t mPeakFrameBytes;
+    
+public:
+    // capacity bytes per frame
+    explicit FrameAllocator(size_t capacity, const char* name = "FrameAllocator");
+    
+    // Swaps arenas and resets the new current one
+    void BeginFrame();
+    
+    __attribute__((always_inline)) void* Allocate(size_t size, size_t alignment = kSimdAlignment)
+    {
+        return mArenas[mCurrent]->Allocate(size, alignment);
+    }
+    
+    template<typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        return mArenas[mCurrent]->New<T>(std::forward<Args>(args)...);
+    }
+    
+    template<typename T>
+    T* NewArray(size_t count)
+    {
+        return mArenas[mCurrent]->NewArray<T>(count);
+    }
+    
+    // Arena of the current frame
+    __attribute__((always_inline)) LinearAllocator& GetArena() { return *mArenas[mCurrent]; }
+    
+    // Most bytes used in a single frame so far
+    __attribute__((always_inline)) size_t GetPeakFrameBytes() const { return mPeakFrameBytes; }
+};
+
+// STL allocator that takes memory from a LinearAllocator. deallocate is a
+// no-op, memory is reclaimed when the arena is reset.
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    
+    LinearAllocator* arena;
+    
+    explicit ArenaAllocator(LinearAllocator& linearAllocator) : arena(&linearAllocator) {}
+    
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& rhs) : arena(rhs.arena) {}
+    
+    T* allocate(size_t count)
+    {
+        void* ptr = arena->Allocate(sizeof(T) * count, alignof(T) > kSimdAlignment ? alignof(T) : kSimdAlignment);
+        if(!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+    
+    void deallocate(T*, size_t) {}
+    
+    template<typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena == rhs.arena; }
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena != rhs.arena; }
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,103 @@
+//
+//  PoolAllocator.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_PoolAllocator_h
+#define CookieEngine_PoolAllocator_h
+
+#include "Allocator.h"
+
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Hands out fixed size blocks from pages of blocksPerPage blocks. Free blocks
+// are kept in an intrusive free list, so Allocate and Free are O(1). Pages are
+// only returned to the system when the pool is destroyed. Not thread safe.
+class PoolAllocator
+{
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+    
+    const char* mName;
+    size_t mBlockSize;
+    size_t mGuardOffset;
+    size_t mStride;
+    size_t mAlignment;
+    size_t mBlocksPerPage;
+    FreeBlock* mFreeList;
+    std::vector<void*> mPages;
+    AllocatorStats mStats;
+    
+    void AllocatePage();
+    
+public:
+    // blockSize bytes per block, every block aligned to alignment
+    PoolAllocator(size_t blockSize, size_t alignment = kSimdAlignment, size_t blocksPerPage = 64,
+                  const char* name = "PoolAllocator");
+    
+    // Reports leaked blocks in debug mode
+    ~PoolAllocator();
+    
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+    
+    // Returns a block or nullptr if the system is out of memory
+    void* Allocate();
+    
+    // Returns ptr to the pool. ptr MUST come from this pool
+    void Free(void* ptr);
+    
+    // Returns true if ptr points into one of this pool's blocks
+    bool Owns(const void* ptr) const;
+    
+    __attribute__((always_inline)) size_t GetBlockSize() const { return mBlockSize; }
+    __attribute__((always_inline)) const AllocatorStats& GetStats() const { return mStats; }
+};
+
+// PoolAllocator sized and aligned for objects of type T
+template<typename T>
+class TypedPool
+{
+private:
+    PoolAllocator mPool;
+    
+public:
+    explicit TypedPool(size_t objectsPerPage = 64, const char* name = "TypedPool")
+        : mPool(sizeof(T), alignof(T) > kSimdAlignment ? alignof(T) : kSimdAlignment, objectsPerPage, name)
+    {
+    }
+    
+    // Constructs a T in a pooled block
+    template<typename... Args>
+    T* New(Args&&... args)
+    {
+        void* ptr = mPool.Allocate();
+        return ptr ? new(ptr) T(std::forward<Args>(args)...) : nullptr;
+    }
+    
+    // Destroys and returns an object created by New
+    void Delete(T* object)
+    {
+        if(object)
+        {
+            object->~T();
+            mPool.Free(object);
+        }
+    }
+    
+    __attribute__((always_inline)) const AllocatorStats& GetStats() const { return mPool.GetStats(); }
+};
+
+} // namespace CookieEngine
+
+#endif
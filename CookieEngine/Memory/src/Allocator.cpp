@@ -0,0 +1,62 @@
+//
+//  Allocator.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Allocator.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace CookieEngine
+{
+
+void* AlignedMalloc(size_t size, size_t alignment)
+{
+    if(alignment < sizeof(void*))
+    {
+        alignment = sizeof(void*);
+    }
+    
+    void* ptr = nullptr;
+    if(posix_memalign(&ptr, alignment, size) != 0)
+    {
+        return nullptr;
+    }
+    return ptr;
+}
+
+void AlignedFree(void* ptr)
+{
+    free(ptr);
+}
+
+void Detail::WriteGuard(void* guard)
+{
+    memset(guard, kGuardByte, kGuardSize);
+}
+
+bool Detail::CheckGuard(const void* guard)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(guard);
+    for(size_t i = 0; i < kGuardSize; i++)
+    {
+        if(bytes[i] != kGuardByte)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Detail::ReportMemoryError(const char* name, const char* message, const void* ptr)
+{
+    std::cerr << "Memory error in " << (name ? name : "allocator") << ": " << message << " (" << ptr << ")\n";
+    assert(false && "Memory error");
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,83 @@
+//
+//  LinearAllocator.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "LinearAllocator.h"
+
+#include <cstring>
+
+namespace CookieEngine
+{
+
+LinearAllocator::LinearAllocator(size_t capacity, const char* name)
+    : mName(name), mBuffer(nullptr), mCapacity(capacity), mOffset(0), mStats()
+{
+    mBuffer = static_cast<uint8_t*>(AlignedMalloc(capacity, 64));
+    if(!mBuffer)
+    {
+        mCapacity = 0;
+    }
+    mStats.reservedBytes = mCapacity;
+}
+
+LinearAllocator::~LinearAllocator()
+{
+#if COOKIE_MEMORY_DEBUG
+    CheckGuards(0);
+#endif
+    AlignedFree(mBuffer);
+}
+
+#if COOKIE_MEMORY_DEBUG
+void LinearAllocator::CheckGuards(size_t fromOffset)
+{
+    while(!mGuards.empty() && mGuards.back() >= fromOffset)
+    {
+        if(!Detail::CheckGuard(mBuffer + mGuards.back()))
+        {
+            Detail::ReportMemoryError(mName, "buffer overrun", mBuffer + mGuards.back());
+        }
+        mGuards.pop_back();
+    }
+}
+#endif
+
+void LinearAllocator::Rewind(Marker marker)
+{
+    if(marker.offset >= mOffset)
+    {
+        return;
+    }
+    
+#if COOKIE_MEMORY_DEBUG
+    CheckGuards(marker.offset);
+    memset(mBuffer + marker.offset, Detail::kFreedByte, mOffset - marker.offset);
+#endif
+    
+    mOffset = marker.offset;
+    mStats.liveAllocations = marker.liveAllocations;
+    mStats.liveBytes = marker.liveBytes;
+}
+
+FrameAllocator::FrameAllocator(size_t capacity, const char* name)
+    : mEvenArena(capacity, name), mOddArena(capacity, name), mCurrent(0), mPeakFrameBytes(0)
+{
+    mArenas[0] = &mEvenArena;
+    mArenas[1] = &mOddArena;
+}
+
+void FrameAllocator::BeginFrame()
+{
+    if(mArenas[mCurrent]->GetUsed() > mPeakFrameBytes)
+    {
+        mPeakFrameBytes = mArenas[mCurrent]->GetUsed();
+    }
+    
+    mCurrent ^= 1;
+    mArenas[mCurrent]->Reset();
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,152 @@
+//
+//  PoolAllocator.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "PoolAllocator.h"
+
+#include <cstring>
+
+namespace CookieEngine
+{
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerPage, const char* name)
+    : mName(name), mBlockSize(blockSize), mGuardOffset(0), mStride(0), mAlignment(alignment),
+      mBlocksPerPage(blocksPerPage ? blocksPerPage : 1), mFreeList(nullptr), mPages(), mStats()
+{
+    if(mAlignment < alignof(FreeBlock))
+    {
+        mAlignment = alignof(FreeBlock);
+    }
+    
+    // The guard sits right behind the block so even small overruns into the padding are caught
+    mGuardOffset = mBlockSize > sizeof(FreeBlock) ? mBlockSize : sizeof(FreeBlock);
+    size_t size = mGuardOffset;
+#if COOKIE_MEMORY_DEBUG
+    size += Detail::kGuardSize;
+#endif
+    mStride = AlignUp(size, mAlignment);
+}
+
+PoolAllocator::~PoolAllocator()
+{
+#if COOKIE_MEMORY_DEBUG
+    if(mStats.liveAllocations != 0)
+    {
+        Detail::ReportMemoryError(mName, "blocks leaked", nullptr);
+    }
+#endif
+    
+    for(size_t i = 0; i < mPages.size(); i++)
+    {
+        AlignedFree(mPages[i]);
+    }
+}
+
+void PoolAllocator::AllocatePage()
+{
+    size_t pageSize = mStride * mBlocksPerPage;
+    uint8_t* page = static_cast<uint8_t*>(AlignedMalloc(pageSize, mAlignment));
+    if(!page)
+    {
+        return;
+    }
+    
+    mPages.push_back(page);
+    mStats.reservedBytes += pageSize;
+    
+    // Thread the new blocks onto the free list back to front so they are handed out in address order
+    for(size_t i = mBlocksPerPage; i > 0; i--)
+    {
+        uint8_t* block = page + (i - 1) * mStride;
+#if COOKIE_MEMORY_DEBUG
+        memset(block, Detail::kFreedByte, mStride);
+#endif
+        FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->next = mFreeList;
+        mFreeList = freeBlock;
+    }
+}
+
+void* PoolAllocator::Allocate()
+{
+    if(!mFreeList)
+    {
+        AllocatePage();
+        if(!mFreeList)
+        {
+            return nullptr;
+        }
+    }
+    
+    FreeBlock* block = mFreeList;
+    mFreeList = block->next;
+    mStats.OnAllocate(mBlockSize);
+    
+#if COOKIE_MEMORY_DEBUG
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(block);
+    memset(bytes, Detail::kAllocatedByte, mBlockSize);
+    Detail::WriteGuard(bytes + mGuardOffset);
+#endif
+    
+    return block;
+}
+
+void PoolAllocator::Free(void* ptr)
+{
+    if(!ptr)
+    {
+        return;
+    }
+    
+#if COOKIE_MEMORY_DEBUG
+    if(!Owns(ptr))
+    {
+        Detail::ReportMemoryError(mName, "freeing a block the pool does not own", ptr);
+        return;
+    }
+    
+    uint8_t* bytes = static_cast<uint8_t*>(ptr);
+    const uint8_t* guard = bytes + mGuardOffset;
+    if(!Detail::CheckGuard(guard))
+    {
+        // A freed block has its guard filled with the freed pattern
+        bool freed = true;
+        for(size_t i = 0; i < Detail::kGuardSize; i++)
+        {
+            freed = freed && guard[i] == Detail::kFreedByte;
+        }
+        Detail::ReportMemoryError(mName, freed ? "double free" : "buffer overrun", ptr);
+        if(freed)
+        {
+            return;
+        }
+    }
+    memset(bytes, Detail::kFreedByte, mStride);
+#endif
+    
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = mFreeList;
+    mFreeList = block;
+    mStats.OnFree(mBlockSize);
+}
+
+bool PoolAllocator::Owns(const void* ptr) const
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+    size_t pageSize = mStride * mBlocksPerPage;
+    
+    for(size_t i = 0; i < mPages.size(); i++)
+    {
+        const uint8_t* page = static_cast<const uint8_t*>(mPages[i]);
+        if(bytes >= page && bytes < page + pageSize)
+        {
+            return (size_t)(bytes - page) % mStride == 0;
+        }
+    }
+    return false;
+}
+
+} // namespace CookieEngine
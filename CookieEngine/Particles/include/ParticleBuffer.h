@@ -0,0 +1,84 @@
+//
+//  ParticleBuffer.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ParticleBuffer_h
+#define CookieEngine_ParticleBuffer_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+// Particle attributes, each one is a separate float stream
+enum ParticleStream
+{
+    PositionX,
+    PositionY,
+    PositionZ,
+    VelocityX,
+    VelocityY,
+    VelocityZ,
+    Life,           // seconds left, the particle dies when it reaches 0
+    InvLifetime,    // 1 / initial life, so life * InvLifetime fades from 1 to 0
+    Size,
+    ColorR,
+    ColorG,
+    ColorB,
+    ColorA,
+    
+    ParticleStreamCount
+};
+
+// Number of particles processed per AVX2 step. Streams are padded and aligned to it.
+static const uint32_t kParticleLaneCount = 8;
+
+// Structure of arrays particle storage with a fixed capacity. Live particles
+// are always packed at the front of every stream. Not thread safe.
+class ParticleBuffer
+{
+private:
+    float* mData;
+    float* mStreams[ParticleStreamCount];
+    uint32_t mCapacity;
+    uint32_t mCount;
+    
+public:
+    // Allocates streams for capacity particles
+    explicit ParticleBuffer(uint32_t capacity);
+    
+    // Destructor
+    ~ParticleBuffer();
+    
+    ParticleBuffer(const ParticleBuffer&) = delete;
+    ParticleBuffer& operator=(const ParticleBuffer&) = delete;
+    
+    // Reserves up to count particles at the end of the live range and returns
+    // the index of the first one. count is clamped to the free capacity.
+    uint32_t Allocate(uint32_t& count);
+    
+    // Sets the number of live particles after compaction
+    __attribute__((always_inline)) void SetCount(uint32_t count) { mCount = count; }
+    
+    // Copies every stream of particle from into particle to
+    void Move(uint32_t from, uint32_t to);
+    
+    // Kills all particles
+    __attribute__((always_inline)) void Clear() { mCount = 0; }
+    
+    // Streams are 32 byte aligned and padded to a multiple of kParticleLaneCount,
+    // so whole SIMD blocks may be read and written past GetCount()
+    __attribute__((always_inline)) float* GetStream(ParticleStream stream) { return mStreams[stream]; }
+    __attribute__((always_inline)) const float* GetStream(ParticleStream stream) const { return mStreams[stream]; }
+    
+    __attribute__((always_inline)) uint32_t GetCount() const { return mCount; }
+    __attribute__((always_inline)) uint32_t GetCapacity() const { return mCapacity; }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,55 @@
+//
+//  ParticleEmitter.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ParticleEmitter_h
+#define CookieEngine_ParticleEmitter_h
+
+#include "ParticleBuffer.h"
+#include "Vector3.h"
+
+namespace CookieEngine
+{
+
+// Spawns particles at a steady rate with attributes picked uniformly from the given ranges
+class ParticleEmitter
+{
+private:
+    float mAccumulator;
+    uint32_t mRandomState;
+    
+    // Uniform float in [0, 1)
+    float NextRandom();
+    
+    // Fills count particles starting at first
+    void Spawn(ParticleBuffer& buffer, uint32_t first, uint32_t count);
+    
+public:
+    Vector3 position;
+    Vector3 positionSpread;     // half extents of the box particles spawn in
+    Vector3 velocityMin;
+    Vector3 velocityMax;
+    float rate;                 // particles per second
+    float lifetimeMin;
+    float lifetimeMax;
+    float sizeMin;
+    float sizeMax;
+    float color[4];
+    bool enabled;
+    
+    // Constructor, seed makes emitters with the same settings differ
+    explicit ParticleEmitter(uint32_t seed = 1);
+    
+    // Spawns the particles due after dt seconds, returns how many were spawned
+    uint32_t Emit(ParticleBuffer& buffer, float dt);
+    
+    // Spawns count particles at once, returns how many fit into buffer
+    uint32_t Burst(ParticleBuffer& buffer, uint32_t count);
+} __attribute__ ((aligned (16)));
+
+} // namespace CookieEngine
+
+#endif
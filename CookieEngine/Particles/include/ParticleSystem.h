@@ -0,0 +1,94 @@
+//
+//  ParticleSystem.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ParticleSystem_h
+#define CookieEngine_ParticleSystem_h
+
+#include "AlignedAllocator.h"
+#include "ParticleBuffer.h"
+#include "ParticleEmitter.h"
+
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+// Forces applied to every particle of a system
+struct ParticleForces
+{
+    float gravity[3];
+    float drag;         // fraction of velocity lost per second
+};
+
+// Interleaved vertex streamed to the GPU for point sprite drawing
+struct ParticleVertex
+{
+    float position[3];
+    float size;
+    float color[4];     // alpha already faded by remaining life
+};
+
+struct ParticleStats
+{
+    uint32_t aliveCount;
+    uint32_t spawnedLastUpdate;
+    uint32_t diedLastUpdate;
+    uint32_t simdWidth;         // 8 when the AVX2 kernels run, 4 for SSE4.1
+};
+
+// Simulates one particle buffer fed by any number of emitters. Integration,
+// forces and compaction of dead particles run 8 particles at a time with
+// AVX2 when the CPU has it, otherwise 4 at a time with SSE4.1.
+class ParticleSystem
+{
+private:
+    ParticleBuffer mBuffer;
+    AlignedVector<ParticleEmitter> mEmitters;
+    ParticleForces mForces;
+    std::vector<uint32_t> mRangeAlive;
+    ParticleStats mStats;
+    
+    // Moves live particles from behind the compacted ranges into their holes
+    void MergeRanges(uint32_t rangeSize);
+    
+public:
+    // capacity is the most particles alive at once
+    explicit ParticleSystem(uint32_t capacity);
+    
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+    
+    // Adds an emitter and returns its index
+    uint32_t AddEmitter(const ParticleEmitter& emitter);
+    
+    __attribute__((always_inline)) ParticleEmitter& GetEmitter(uint32_t index) { return mEmitters[index]; }
+    __attribute__((always_inline)) uint32_t GetEmitterCount() const { return (uint32_t)mEmitters.size(); }
+    
+    __attribute__((always_inline)) void SetForces(const ParticleForces& forces) { mForces = forces; }
+    __attribute__((always_inline)) const ParticleForces& GetForces() const { return mForces; }
+    
+    // Ages, integrates and compacts all particles, then lets the emitters
+    // spawn. Work is split over jobs if it is not nullptr.
+    void Update(float dt, JobSystem* jobs);
+    
+    // Writes at most maxCount live particles into out and returns how many
+    // were written. out does not need any alignment, so it may be a mapped GL buffer.
+    uint32_t WriteVertices(ParticleVertex* out, uint32_t maxCount, JobSystem* jobs) const;
+    
+    // Kills all particles
+    void Clear();
+    
+    __attribute__((always_inline)) const ParticleBuffer& GetBuffer() const { return mBuffer; }
+    __attribute__((always_inline)) uint32_t GetAliveCount() const { return mBuffer.GetCount(); }
+    __attribute__((always_inline)) const ParticleStats& GetStats() const { return mStats; }
+};
+
+} // namespace CookieEngine
+
+#endif
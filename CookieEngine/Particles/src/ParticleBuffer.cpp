@@ -0,0 +1,60 @@
+//
+//  ParticleBuffer.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ParticleBuffer.h"
+#include "Allocator.h"
+
+#include <cstring>
+
+namespace CookieEngine
+{
+
+ParticleBuffer::ParticleBuffer(uint32_t capacity) : mData(nullptr), mCapacity(capacity), mCount(0)
+{
+    size_t streamFloats = AlignUp(capacity ? capacity : 1, kParticleLaneCount);
+    mData = static_cast<float*>(AlignedMalloc(streamFloats * ParticleStreamCount * sizeof(float), kAvxAlignment));
+    if(!mData)
+    {
+        mCapacity = 0;
+        streamFloats = 0;
+    }
+    else
+    {
+        // Zero the padding too, SIMD kernels read it
+        memset(mData, 0, streamFloats * ParticleStreamCount * sizeof(float));
+    }
+    
+    for(int i = 0; i < ParticleStreamCount; i++)
+    {
+        mStreams[i] = mData + streamFloats * i;
+    }
+}
+
+ParticleBuffer::~ParticleBuffer()
+{
+    AlignedFree(mData);
+}
+
+uint32_t ParticleBuffer::Allocate(uint32_t& count)
+{
+    uint32_t available = mCapacity - mCount;
+    count = count < available ? count : available;
+    
+    uint32_t first = mCount;
+    mCount += count;
+    return first;
+}
+
+void ParticleBuffer::Move(uint32_t from, uint32_t to)
+{
+    for(int i = 0; i < ParticleStreamCount; i++)
+    {
+        mStreams[i][to] = mStreams[i][from];
+    }
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,96 @@
+//
+//  ParticleEmitter.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ParticleEmitter.h"
+
+namespace CookieEngine
+{
+
+ParticleEmitter::ParticleEmitter(uint32_t seed)
+    : mAccumulator(0.0f), mRandomState(seed ? seed : 1), position(Vector3::Zero), positionSpread(Vector3::Zero),
+      velocityMin(Vector3::Zero), velocityMax(Vector3::Zero), rate(0.0f), lifetimeMin(1.0f), lifetimeMax(1.0f),
+      sizeMin(1.0f), sizeMax(1.0f), enabled(true)
+{
+    color[0] = color[1] = color[2] = color[3] = 1.0f;
+}
+
+float ParticleEmitter::NextRandom()
+{
+    // xorshift32, plenty for visual effects and cheap enough for bursts of thousands
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    return (mRandomState >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t ParticleEmitter::Emit(ParticleBuffer& buffer, float dt)
+{
+    if(!enabled)
+    {
+        return 0;
+    }
+    
+    mAccumulator += rate * dt;
+    uint32_t count = (uint32_t)mAccumulator;
+    mAccumulator -= (float)count;
+    
+    return Burst(buffer, count);
+}
+
+uint32_t ParticleEmitter::Burst(ParticleBuffer& buffer, uint32_t count)
+{
+    uint32_t first = buffer.Allocate(count);
+    Spawn(buffer, first, count);
+    return count;
+}
+
+void ParticleEmitter::Spawn(ParticleBuffer& buffer, uint32_t first, uint32_t count)
+{
+    float* px = buffer.GetStream(PositionX);
+    float* py = buffer.GetStream(PositionY);
+    float* pz = buffer.GetStream(PositionZ);
+    float* vx = buffer.GetStream(VelocityX);
+    float* vy = buffer.GetStream(VelocityY);
+    float* vz = buffer.GetStream(VelocityZ);
+    float* life = buffer.GetStream(Life);
+    float* invLifetime = buffer.GetStream(InvLifetime);
+    float* size = buffer.GetStream(Size);
+    float* r = buffer.GetStream(ColorR);
+    float* g = buffer.GetStream(ColorG);
+    float* b = buffer.GetStream(ColorB);
+    float* a = buffer.GetStream(ColorA);
+    
+    float origin[3] = { position.GetX(), position.GetY(), position.GetZ() };
+    float spread[3] = { positionSpread.GetX(), positionSpread.GetY(), positionSpread.GetZ() };
+    float minVelocity[3] = { velocityMin.GetX(), velocityMin.GetY(), velocityMin.GetZ() };
+    float velocityRange[3] = { velocityMax.GetX() - minVelocity[0], velocityMax.GetY() - minVelocity[1],
+                               velocityMax.GetZ() - minVelocity[2] };
+    
+    for(uint32_t i = first; i < first + count; i++)
+    {
+        px[i] = origin[0] + spread[0] * (NextRandom() * 2.0f - 1.0f);
+        py[i] = origin[1] + spread[1] * (NextRandom() * 2.0f - 1.0f);
+        pz[i] = origin[2] + spread[2] * (NextRandom() * 2.0f - 1.0f);
+        vx[i] = minVelocity[0] + velocityRange[0] * NextRandom();
+        vy[i] = minVelocity[1] + velocityRange[1] * NextRandom();
+        vz[i] = minVelocity[2] + velocityRange[2] * NextRandom();
+        
+        // A zero lifetime would make InvLifetime infinite
+        float lifetime = lifetimeMin + (lifetimeMax - lifetimeMin) * NextRandom();
+        lifetime = lifetime > 1e-4f ? lifetime : 1e-4f;
+        life[i] = lifetime;
+        invLifetime[i] = 1.0f / lifetime;
+        
+        size[i] = sizeMin + (sizeMax - sizeMin) * NextRandom();
+        r[i] = color[0];
+        g[i] = color[1];
+        b[i] = color[2];
+        a[i] = color[3];
+    }
+}
+
+} // namespace CookieEngine
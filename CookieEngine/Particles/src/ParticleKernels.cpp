@@ -0,0 +1,283 @@
+//
+//  ParticleKernels.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ParticleKernels.h"
+
+#include <cstddef>
+#include <immintrin.h>
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+// Vertices are written as two 4 float halves
+static_assert(offsetof(ParticleVertex, size) == 3 * sizeof(float) && offsetof(ParticleVertex, color) == 4 * sizeof(float),
+              "ParticleVertex must be position, size and color without padding");
+
+namespace
+{
+    // Streams the update kernels only copy while compacting
+    const ParticleStream kPassiveStreams[] = { InvLifetime, Size, ColorR, ColorG, ColorB, ColorA };
+    const int kPassiveStreamCount = sizeof(kPassiveStreams) / sizeof(kPassiveStreams[0]);
+    
+    // pshufb masks moving the lanes set in a 4 bit mask to the front
+    struct PackTable4
+    {
+        __m128i shuffles[16];
+        
+        PackTable4()
+        {
+            for(int mask = 0; mask < 16; mask++)
+            {
+                uint8_t bytes[16] = {};
+                int lane = 0;
+                for(int i = 0; i < 4; i++)
+                {
+                    if(mask & (1 << i))
+                    {
+                        for(int b = 0; b < 4; b++)
+                        {
+                            bytes[lane * 4 + b] = (uint8_t)(i * 4 + b);
+                        }
+                        lane++;
+                    }
+                }
+                shuffles[mask] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+            }
+        }
+    };
+    
+    // vpermps indices moving the lanes set in an 8 bit mask to the front
+    struct PackTable8
+    {
+        uint32_t indices[256][8] __attribute__((aligned(32)));
+        
+        PackTable8()
+        {
+            for(int mask = 0; mask < 256; mask++)
+            {
+                int lane = 0;
+                for(int i = 0; i < 8; i++)
+                {
+                    if(mask & (1 << i))
+                    {
+                        indices[mask][lane++] = (uint32_t)i;
+                    }
+                }
+                while(lane < 8)
+                {
+                    indices[mask][lane++] = 0;
+                }
+            }
+        }
+    };
+    
+    const PackTable4& GetPackTable4()
+    {
+        static const PackTable4 table;
+        return table;
+    }
+    
+    const PackTable8& GetPackTable8()
+    {
+        static const PackTable8 table;
+        return table;
+    }
+    
+    __attribute__((always_inline)) inline __m128 Pack4(__m128 value, __m128i shuffle)
+    {
+        return _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(value), shuffle));
+    }
+    
+    __attribute__((always_inline)) inline float DragScale(const ParticleForces& forces, float dt)
+    {
+        float scale = 1.0f - forces.drag * dt;
+        return scale > 0.0f ? scale : 0.0f;
+    }
+} // namespace
+
+bool HasAvx2()
+{
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return hasAvx2;
+}
+
+uint32_t UpdateParticlesSse(ParticleBuffer& buffer, uint32_t begin, uint32_t end,
+                            const ParticleForces& forces, float dt)
+{
+    const PackTable4& table = GetPackTable4();
+    
+    float* px = buffer.GetStream(PositionX);
+    float* py = buffer.GetStream(PositionY);
+    float* pz = buffer.GetStream(PositionZ);
+    float* vx = buffer.GetStream(VelocityX);
+    float* vy = buffer.GetStream(VelocityY);
+    float* vz = buffer.GetStream(VelocityZ);
+    float* life = buffer.GetStream(Life);
+    
+    __m128 delta = _mm_set_ps1(dt);
+    __m128 zero = _mm_setzero_ps();
+    __m128 dragScale = _mm_set_ps1(DragScale(forces, dt));
+    __m128 gravityX = _mm_set_ps1(forces.gravity[0] * dt);
+    __m128 gravityY = _mm_set_ps1(forces.gravity[1] * dt);
+    __m128 gravityZ = _mm_set_ps1(forces.gravity[2] * dt);
+    
+    // Survivors are written at out, which never passes the block being read
+    uint32_t out = begin;
+    for(uint32_t i = begin; i < end; i += 4)
+    {
+        __m128 remaining = _mm_sub_ps(_mm_load_ps(life + i), delta);
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(remaining, zero));
+        if(end - i < 4)
+        {
+            mask &= (1 << (end - i)) - 1;
+        }
+        __m128i shuffle = table.shuffles[mask];
+        
+        __m128 velX = _mm_add_ps(_mm_mul_ps(_mm_load_ps(vx + i), dragScale), gravityX);
+        __m128 velY = _mm_add_ps(_mm_mul_ps(_mm_load_ps(vy + i), dragScale), gravityY);
+        __m128 velZ = _mm_add_ps(_mm_mul_ps(_mm_load_ps(vz + i), dragScale), gravityZ);
+        __m128 posX = _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(velX, delta));
+        __m128 posY = _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(velY, delta));
+        __m128 posZ = _mm_add_ps(_mm_load_ps(pz + i), _mm_mul_ps(velZ, delta));
+        
+        _mm_storeu_ps(px + out, Pack4(posX, shuffle));
+        _mm_storeu_ps(py + out, Pack4(posY, shuffle));
+        _mm_storeu_ps(pz + out, Pack4(posZ, shuffle));
+        _mm_storeu_ps(vx + out, Pack4(velX, shuffle));
+        _mm_storeu_ps(vy + out, Pack4(velY, shuffle));
+        _mm_storeu_ps(vz + out, Pack4(velZ, shuffle));
+        _mm_storeu_ps(life + out, Pack4(remaining, shuffle));
+        
+        for(int s = 0; s < kPassiveStreamCount; s++)
+        {
+            float* stream = buffer.GetStream(kPassiveStreams[s]);
+            _mm_storeu_ps(stream + out, Pack4(_mm_load_ps(stream + i), shuffle));
+        }
+        
+        out += (uint32_t)__builtin_popcount(mask);
+    }
+    
+    return out - begin;
+}
+
+__attribute__((target("avx2,fma")))
+uint32_t UpdateParticlesAvx2(ParticleBuffer& buffer, uint32_t begin, uint32_t end,
+                             const ParticleForces& forces, float dt)
+{
+    const PackTable8& table = GetPackTable8();
+    
+    float* px = buffer.GetStream(PositionX);
+    float* py = buffer.GetStream(PositionY);
+    float* pz = buffer.GetStream(PositionZ);
+    float* vx = buffer.GetStream(VelocityX);
+    float* vy = buffer.GetStream(VelocityY);
+    float* vz = buffer.GetStream(VelocityZ);
+    float* life = buffer.GetStream(Life);
+    
+    __m256 delta = _mm256_set1_ps(dt);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 dragScale = _mm256_set1_ps(DragScale(forces, dt));
+    __m256 gravityX = _mm256_set1_ps(forces.gravity[0] * dt);
+    __m256 gravityY = _mm256_set1_ps(forces.gravity[1] * dt);
+    __m256 gravityZ = _mm256_set1_ps(forces.gravity[2] * dt);
+    
+    // Survivors are written at out, which never passes the block being read
+    uint32_t out = begin;
+    for(uint32_t i = begin; i < end; i += 8)
+    {
+        __m256 remaining = _mm256_sub_ps(_mm256_load_ps(life + i), delta);
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(remaining, zero, _CMP_GT_OQ));
+        if(end - i < 8)
+        {
+            mask &= (1 << (end - i)) - 1;
+        }
+        __m256i permute = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.indices[mask]));
+        
+        __m256 velX = _mm256_fmadd_ps(_mm256_load_ps(vx + i), dragScale, gravityX);
+        __m256 velY = _mm256_fmadd_ps(_mm256_load_ps(vy + i), dragScale, gravityY);
+        __m256 velZ = _mm256_fmadd_ps(_mm256_load_ps(vz + i), dragScale, gravityZ);
+        __m256 posX = _mm256_fmadd_ps(velX, delta, _mm256_load_ps(px + i));
+        __m256 posY = _mm256_fmadd_ps(velY, delta, _mm256_load_ps(py + i));
+        __m256 posZ = _mm256_fmadd_ps(velZ, delta, _mm256_load_ps(pz + i));
+        
+        _mm256_storeu_ps(px + out, _mm256_permutevar8x32_ps(posX, permute));
+        _mm256_storeu_ps(py + out, _mm256_permutevar8x32_ps(posY, permute));
+        _mm256_storeu_ps(pz + out, _mm256_permutevar8x32_ps(posZ, permute));
+        _mm256_storeu_ps(vx + out, _mm256_permutevar8x32_ps(velX, permute));
+        _mm256_storeu_ps(vy + out, _mm256_permutevar8x32_ps(velY, permute));
+        _mm256_storeu_ps(vz + out, _mm256_permutevar8x32_ps(velZ, permute));
+        _mm256_storeu_ps(life + out, _mm256_permutevar8x32_ps(remaining, permute));
+        
+        for(int s = 0; s < kPassiveStreamCount; s++)
+        {
+            float* stream = buffer.GetStream(kPassiveStreams[s]);
+            _mm256_storeu_ps(stream + out, _mm256_permutevar8x32_ps(_mm256_load_ps(stream + i), permute));
+        }
+        
+        out += (uint32_t)__builtin_popcount(mask);
+    }
+    
+    return out - begin;
+}
+
+void WriteParticleVertices(const ParticleBuffer& buffer, uint32_t begin, uint32_t end, ParticleVertex* out)
+{
+    const float* px = buffer.GetStream(PositionX);
+    const float* py = buffer.GetStream(PositionY);
+    const float* pz = buffer.GetStream(PositionZ);
+    const float* life = buffer.GetStream(Life);
+    const float* invLifetime = buffer.GetStream(InvLifetime);
+    const float* size = buffer.GetStream(Size);
+    const float* r = buffer.GetStream(ColorR);
+    const float* g = buffer.GetStream(ColorG);
+    const float* b = buffer.GetStream(ColorB);
+    const float* a = buffer.GetStream(ColorA);
+    
+    uint32_t i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+        // Transposing 4 particles of 4 streams gives 4 interleaved half vertices
+        __m128 x = _mm_loadu_ps(px + i);
+        __m128 y = _mm_loadu_ps(py + i);
+        __m128 z = _mm_loadu_ps(pz + i);
+        __m128 s = _mm_loadu_ps(size + i);
+        _MM_TRANSPOSE4_PS(x, y, z, s);
+        
+        __m128 red = _mm_loadu_ps(r + i);
+        __m128 green = _mm_loadu_ps(g + i);
+        __m128 blue = _mm_loadu_ps(b + i);
+        __m128 alpha = _mm_mul_ps(_mm_loadu_ps(a + i), _mm_mul_ps(_mm_loadu_ps(life + i), _mm_loadu_ps(invLifetime + i)));
+        _MM_TRANSPOSE4_PS(red, green, blue, alpha);
+        
+        _mm_storeu_ps(out[i + 0].position, x);
+        _mm_storeu_ps(out[i + 0].color, red);
+        _mm_storeu_ps(out[i + 1].position, y);
+        _mm_storeu_ps(out[i + 1].color, green);
+        _mm_storeu_ps(out[i + 2].position, z);
+        _mm_storeu_ps(out[i + 2].color, blue);
+        _mm_storeu_ps(out[i + 3].position, s);
+        _mm_storeu_ps(out[i + 3].color, alpha);
+    }
+    
+    for(; i < end; i++)
+    {
+        ParticleVertex& vertex = out[i];
+        vertex.position[0] = px[i];
+        vertex.position[1] = py[i];
+        vertex.position[2] = pz[i];
+        vertex.size = size[i];
+        vertex.color[0] = r[i];
+        vertex.color[1] = g[i];
+        vertex.color[2] = b[i];
+        vertex.color[3] = a[i] * life[i] * invLifetime[i];
+    }
+}
+
+} // namespace Detail
+} // namespace CookieEngine
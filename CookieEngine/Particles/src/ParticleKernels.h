@@ -0,0 +1,36 @@
+//
+//  ParticleKernels.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ParticleKernels_h
+#define CookieEngine_ParticleKernels_h
+
+#include "ParticleBuffer.h"
+#include "ParticleSystem.h"
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+// Integrates particles [begin, end) and packs the survivors to the front of
+// the range, keeping their order. begin MUST be a multiple of kParticleLaneCount.
+// Returns the number of survivors.
+uint32_t UpdateParticlesSse(ParticleBuffer& buffer, uint32_t begin, uint32_t end,
+                            const ParticleForces& forces, float dt);
+uint32_t UpdateParticlesAvx2(ParticleBuffer& buffer, uint32_t begin, uint32_t end,
+                             const ParticleForces& forces, float dt);
+
+// True if the CPU runs the AVX2 kernels
+bool HasAvx2();
+
+// Converts particles [begin, end) to interleaved vertices at out[begin]
+void WriteParticleVertices(const ParticleBuffer& buffer, uint32_t begin, uint32_t end, ParticleVertex* out);
+
+} // namespace Detail
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,161 @@
+//
+//  ParticleSystem.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ParticleSystem.h"
+#include "ParticleKernels.h"
+#include "JobSystem.h"
+
+namespace CookieEngine
+{
+
+// Particles per job. A multiple of kParticleLaneCount so every range starts on
+// an aligned block, and large enough that merging the ranges stays cheap.
+static const uint32_t kParticleGrainSize = 16384;
+
+ParticleSystem::ParticleSystem(uint32_t capacity)
+    : mBuffer(capacity), mEmitters(), mForces(), mRangeAlive(), mStats()
+{
+    mForces.gravity[0] = 0.0f;
+    mForces.gravity[1] = -9.81f;
+    mForces.gravity[2] = 0.0f;
+    mForces.drag = 0.0f;
+    mStats.simdWidth = Detail::HasAvx2() ? 8 : 4;
+}
+
+uint32_t ParticleSystem::AddEmitter(const ParticleEmitter& emitter)
+{
+    mEmitters.push_back(emitter);
+    return (uint32_t)mEmitters.size() - 1;
+}
+
+void ParticleSystem::Update(float dt, JobSystem* jobs)
+{
+    uint32_t count = mBuffer.GetCount();
+    uint32_t alive = 0;
+    
+    if(count > 0)
+    {
+        uint32_t (*kernel)(ParticleBuffer&, uint32_t, uint32_t, const ParticleForces&, float) =
+            Detail::HasAvx2() ? Detail::UpdateParticlesAvx2 : Detail::UpdateParticlesSse;
+        
+        uint32_t rangeSize = jobs ? kParticleGrainSize : count;
+        uint32_t rangeCount = (count + rangeSize - 1) / rangeSize;
+        mRangeAlive.resize(rangeCount);
+        
+        // Jobs are handed whole ranges, MergeRanges relies on every range having
+        // been compacted on its own whatever shape ParallelFor splits work into
+        auto updateRanges = [&](uint32_t firstRange, uint32_t lastRange)
+        {
+            for(uint32_t r = firstRange; r < lastRange; r++)
+            {
+                uint32_t begin = r * rangeSize;
+                uint32_t end = count - begin > rangeSize ? begin + rangeSize : count;
+                mRangeAlive[r] = kernel(mBuffer, begin, end, mForces, dt);
+            }
+        };
+        
+        if(jobs && rangeCount > 1)
+        {
+            jobs->ParallelFor(rangeCount, 1, updateRanges);
+        }
+        else
+        {
+            updateRanges(0, rangeCount);
+        }
+        
+        MergeRanges(rangeSize);
+        alive = mBuffer.GetCount();
+    }
+    
+    uint32_t spawned = 0;
+    for(size_t i = 0; i < mEmitters.size(); i++)
+    {
+        spawned += mEmitters[i].Emit(mBuffer, dt);
+    }
+    
+    mStats.diedLastUpdate = count - alive;
+    mStats.spawnedLastUpdate = spawned;
+    mStats.aliveCount = mBuffer.GetCount();
+}
+
+void ParticleSystem::MergeRanges(uint32_t rangeSize)
+{
+    uint32_t count = mBuffer.GetCount();
+    uint32_t rangeCount = (uint32_t)mRangeAlive.size();
+    
+    uint32_t total = 0;
+    for(uint32_t i = 0; i < rangeCount; i++)
+    {
+        total += mRangeAlive[i];
+    }
+    
+    // Every range has its survivors at the front. Holes below total are filled
+    // with the last survivors above it, so only dead particles cost a copy.
+    uint32_t hole = 0;
+    uint32_t holeIndex = mRangeAlive[0];
+    uint32_t source = rangeCount - 1;
+    int64_t sourceIndex = (int64_t)source * rangeSize + mRangeAlive[source] - 1;
+    
+    for(;;)
+    {
+        while(hole < rangeCount)
+        {
+            uint32_t rangeEnd = (hole + 1) * rangeSize < count ? (hole + 1) * rangeSize : count;
+            if(holeIndex < rangeEnd)
+            {
+                break;
+            }
+            if(++hole < rangeCount)
+            {
+                holeIndex = hole * rangeSize + mRangeAlive[hole];
+            }
+        }
+        if(hole == rangeCount || holeIndex >= total)
+        {
+            break;
+        }
+        
+        while(sourceIndex < (int64_t)source * rangeSize)
+        {
+            source--;
+            sourceIndex = (int64_t)source * rangeSize + mRangeAlive[source] - 1;
+        }
+        
+        mBuffer.Move((uint32_t)sourceIndex, holeIndex);
+        holeIndex++;
+        sourceIndex--;
+    }
+    
+    mBuffer.SetCount(total);
+}
+
+uint32_t ParticleSystem::WriteVertices(ParticleVertex* out, uint32_t maxCount, JobSystem* jobs) const
+{
+    uint32_t count = mBuffer.GetCount() < maxCount ? mBuffer.GetCount() : maxCount;
+    
+    if(jobs && count > kParticleGrainSize)
+    {
+        jobs->ParallelFor(count, kParticleGrainSize, [&](uint32_t begin, uint32_t end)
+        {
+            Detail::WriteParticleVertices(mBuffer, begin, end, out);
+        });
+    }
+    else
+    {
+        Detail::WriteParticleVertices(mBuffer, 0, count, out);
+    }
+    
+    return count;
+}
+
+void ParticleSystem::Clear()
+{
+    mBuffer.Clear();
+    mStats.aliveCount = 0;
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,97 @@
+//
+//  GraphicsFunctions.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_GraphicsFunctions_h
+#define CookieEngine_GraphicsFunctions_h
+
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+enum class PrimitiveType : uint8_t
+{
+    Points,
+    Lines,
+    LineStrip,
+    Triangles,
+    TriangleStrip,
+};
+
+enum class IndexType : uint8_t
+{
+    UInt16,
+    UInt32,
+};
+
+// Layout of the values of a uniform, one element of an array each
+enum class UniformType : uint8_t
+{
+    Float,
+    Float2,
+    Float3,
+    Float4,
+    Int,
+    Matrix4,    // row-major Matrix4, transposed for the shader on upload
+};
+
+// Buffers cleared by a Clear command
+enum ClearFlags : uint32_t
+{
+    ClearColor = 1 << 0,
+    ClearDepth = 1 << 1,
+    ClearStencil = 1 << 2,
+};
+
+// Graphics API entry points the render commands replay through. Resources
+// are referred to by their API handles (GL object names). Every function
+// gets context as its first argument, the OpenGL table ignores it and a
+// MockGraphics table uses it to find its call log.
+struct GraphicsFunctions
+{
+    void* context;
+    
+    void (*clear)(void* context, uint32_t flags, const float* color, float depth);
+    void (*viewport)(void* context, int32_t x, int32_t y, int32_t width, int32_t height);
+    void (*useProgram)(void* context, uint32_t program);
+    
+    // values holds count elements of type, ints are stored as int32_t
+    void (*uniform)(void* context, int32_t location, UniformType type, uint32_t count, const void* values);
+    
+    void (*bindVertexArray)(void* context, uint32_t vertexArray);
+    void (*bindTexture)(void* context, uint32_t unit, uint32_t texture);
+    void (*bindUniformBuffer)(void* context, uint32_t binding, uint32_t buffer);
+    void (*drawArrays)(void* context, PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount);
+    
+    // firstIndex counts indices, not bytes
+    void (*drawElements)(void* context, PrimitiveType primitive, IndexType indexType, uint32_t firstIndex,
+                         uint32_t count, uint32_t instanceCount);
+};
+
+// Returns the size in bytes of one element of a uniform of type
+__attribute__((always_inline)) inline uint32_t GetUniformSize(UniformType type)
+{
+    switch(type)
+    {
+        case UniformType::Float:
+        case UniformType::Int:
+            return 4;
+        case UniformType::Float2:
+            return 8;
+        case UniformType::Float3:
+            return 12;
+        case UniformType::Float4:
+            return 16;
+        case UniformType::Matrix4:
+            return 64;
+    }
+    return 0;
+}
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,86 @@
+//
+//  MockGraphics.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_MockGraphics_h
+#define CookieEngine_MockGraphics_h
+
+#include "GraphicsFunctions.h"
+
+#include <vector>
+
+namespace CookieEngine
+{
+
+enum class GraphicsCallType : uint8_t
+{
+    Clear,
+    Viewport,
+    UseProgram,
+    Uniform,
+    BindVertexArray,
+    BindTexture,
+    BindUniformBuffer,
+    DrawArrays,
+    DrawElements,
+};
+
+// One call made through a MockGraphics table
+struct GraphicsCall
+{
+    GraphicsCallType type;
+    uint32_t args[6];           // integer and enum arguments in parameter order
+    uint32_t valueOffset;       // clear color and depth, or uniform values, in GetValues
+    uint32_t valueCount;        // 4 byte words
+};
+
+// Graphics table that logs every call instead of drawing, so render command
+// recording and replay can be checked on machines without a GPU
+class MockGraphics
+{
+private:
+    std::vector<GraphicsCall> mCalls;
+    std::vector<float> mValues;
+    
+    static MockGraphics& From(void* context) { return *static_cast<MockGraphics*>(context); }
+    
+    GraphicsCall& AddCall(GraphicsCallType type, const void* values = nullptr, uint32_t valueCount = 0);
+    
+    static void Clear(void* context, uint32_t flags, const float* color, float depth);
+    static void Viewport(void* context, int32_t x, int32_t y, int32_t width, int32_t height);
+    static void UseProgram(void* context, uint32_t program);
+    static void Uniform(void* context, int32_t location, UniformType type, uint32_t count, const void* values);
+    static void BindVertexArray(void* context, uint32_t vertexArray);
+    static void BindTexture(void* context, uint32_t unit, uint32_t texture);
+    static void BindUniformBuffer(void* context, uint32_t binding, uint32_t buffer);
+    static void DrawArrays(void* context, PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount);
+    static void DrawElements(void* context, PrimitiveType primitive, IndexType indexType, uint32_t firstIndex,
+                             uint32_t count, uint32_t instanceCount);
+    
+public:
+    MockGraphics();
+    
+    // Table whose calls are logged by this object
+    GraphicsFunctions GetFunctions();
+    
+    __attribute__((always_inline)) const std::vector<GraphicsCall>& GetCalls() const { return mCalls; }
+    
+    // Values of a Clear or Uniform call. Int uniforms keep their bits.
+    __attribute__((always_inline)) const float* GetValues(const GraphicsCall& call) const
+    {
+        return call.valueCount > 0 ? &mValues[call.valueOffset] : nullptr;
+    }
+    
+    // Number of logged calls of type
+    uint32_t CountCalls(GraphicsCallType type) const;
+    
+    // Forgets the log
+    void Reset();
+};
+
+} // namespace CookieEngine
+
+#endif
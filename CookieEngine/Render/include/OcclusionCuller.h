@@ -0,0 +1,172 @@
+//
+//  OcclusionCuller.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_OcclusionCuller_h
+#define CookieEngine_OcclusionCuller_h
+
+#include "AlignedAllocator.h"
+#include "Matrix4.h"
+#include "Vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+namespace Detail
+{
+
+// Occluder triangle ready for rasterization. The edge functions a * x + b * y + c
+// are positive inside whatever the winding was and depth is the plane
+// z = depthA * x + depthB * y + depthC, no farther than maxDepth anywhere
+// inside. Bounds are whole pixels, max excluded, and fit int16_t because the
+// buffer is kept under 32768 pixels a side.
+struct ScreenTriangle
+{
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    float depthA;
+    float depthB;
+    float depthC;
+    float maxDepth;
+    int16_t minX;
+    int16_t minY;
+    int16_t maxX;
+    int16_t maxY;
+} __attribute__ ((aligned (64)));
+
+// Depth of an 8x4 pixel tile in two layers. Bit y * 8 + x of mask is set when
+// pixel (x, y) of the tile is covered by the working layer, where no occluder
+// is farther than z1. No occluder is farther than z0 at the other pixels.
+struct MaskedTile
+{
+    uint32_t mask;
+    float z0;
+    float z1;
+};
+
+} // namespace Detail
+
+struct OcclusionStats
+{
+    double rasterizeTime;           // seconds spent in the last RasterizeOccluders
+    uint32_t occluderCount;
+    uint32_t occluderTriangles;
+    uint32_t rasterizedTriangles;   // left after dropping the ones off screen or crossing the near plane
+    uint32_t testedCount;           // boxes passed to TestVisibility since BeginFrame
+    uint32_t culledCount;
+    uint32_t simdWidth;             // 8 when the AVX2 rasterizer runs, 4 for SSE4.1
+};
+
+// Software occlusion culling for draws. A few large occluder meshes are
+// rasterized on the CPU into a small depth buffer, then the screen bounds of
+// each draw's box are tested against it and the ones fully behind the
+// occluders can be skipped.
+//
+// The buffer stores no depth per pixel. It follows Andersson et al., Masked
+// Software Occlusion Culling: every 8x4 pixel tile keeps a reference depth z0,
+// a working depth z1 and a 32 bit mask of the pixels the working layer covers.
+// Each triangle only yields its coverage of a tile and its farthest depth over
+// it. Coverage is merged into the working layer until the mask is full, then
+// the working layer replaces the reference one. Both depths are conservative,
+// so a box behind them is hidden, at the price of some boxes behind occluders
+// with very different depths in one tile staying visible.
+//
+// The buffer is split into 64x32 pixel bins. Triangle setup runs per range of
+// occluders and sorts triangles into the bins they touch, then each bin is
+// rasterized by one job, 8 pixels at a time with AVX2 or 4 with SSE4.1, so no
+// two jobs write the same tile. Box tests read whole tiles, never pixels.
+//
+// Per frame: BeginFrame, AddOccluder for each occluder, RasterizeOccluders,
+// then any number of IsVisible or TestVisibility calls.
+class OcclusionCuller
+{
+private:
+    struct Occluder
+    {
+        Matrix4 transform;          // world to clip space
+        const float* positions;
+        const uint32_t* indices;
+        uint32_t stride;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+    
+    uint32_t mWidth;
+    uint32_t mHeight;
+    uint32_t mBinsX;
+    uint32_t mBinsY;
+    Matrix4 mViewProjection;
+    AlignedVector<Occluder> mOccluders;
+    std::vector<Detail::MaskedTile> mTiles;
+    
+    // Setup output. Triangle i of occluder o lands at mTriangleOffsets[o] + i,
+    // and mBins[range * binCount + bin] lists the ones range sent to bin.
+    AlignedVector<Detail::ScreenTriangle> mTriangles;
+    std::vector<uint32_t> mTriangleOffsets;
+    std::vector<std::vector<uint32_t>> mBins;
+    std::vector<uint32_t> mRangeTriangles;
+    std::vector<std::vector<float>> mVertexScratch;     // transformed vertices, one buffer per thread
+    
+    OcclusionStats mStats;
+    
+    // Transforms and sets up the triangles of occluders [begin, end) and bins them for range
+    void SetupOccluders(uint32_t range, uint32_t begin, uint32_t end, std::vector<float>& vertices);
+    
+    // Clears the tiles of bin and rasterizes every triangle sent to it
+    void RasterizeBin(uint32_t bin, uint32_t rangeCount);
+    
+    // Returns true if some pixel of [minX, maxX) x [minY, maxY) may not be nearer than depth
+    bool IsRectVisible(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float depth) const;
+    
+public:
+    // Buffer size in pixels, rounded up to whole bins and kept under 32768. It
+    // only needs to be big enough to resolve the occluders, a fraction of the
+    // screen is plenty.
+    explicit OcclusionCuller(uint32_t width = 320, uint32_t height = 192);
+    
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+    
+    // Forgets the occluders of the last frame. viewProjection is the
+    // Concatenate(projection, view) the frame renders with.
+    void BeginFrame(const Matrix4& viewProjection);
+    
+    // Adds triangleCount triangles of 3 indices each, placed by world.
+    // positions points to the x of the first vertex and consecutive vertices
+    // are stride bytes apart. Nothing is copied, the data MUST stay alive
+    // until RasterizeOccluders returns. Occluders are double sided and should
+    // be solid, simple shapes: walls, floors, large props.
+    void AddOccluder(const float* positions, uint32_t stride, uint32_t vertexCount,
+                     const uint32_t* indices, uint32_t triangleCount, const Matrix4& world);
+    
+    // Rasterizes every occluder added since BeginFrame, on jobs if it is not nullptr
+    void RasterizeOccluders(JobSystem* jobs);
+    
+    // Returns false if the world space box is off screen or hidden behind the
+    // occluders. Boxes crossing the near plane are always visible.
+    bool IsVisible(const Vector3& min, const Vector3& max) const;
+    
+    // Runs IsVisible for count boxes, split over jobs if it is not nullptr, and counts the culled ones
+    void TestVisibility(const Vector3* mins, const Vector3* maxs, uint32_t count, bool* visible, JobSystem* jobs);
+    
+    __attribute__((always_inline)) uint32_t GetWidth() const { return mWidth; }
+    __attribute__((always_inline)) uint32_t GetHeight() const { return mHeight; }
+    
+    // Tiles of 8x4 pixels row by row, GetWidth() / 8 of them per row
+    __attribute__((always_inline)) const Detail::MaskedTile* GetTiles() const { return mTiles.data(); }
+    
+    __attribute__((always_inline)) const OcclusionStats& GetStats() const { return mStats; }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,12 @@
+//
+//  Render.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "GraphicsFunctions.h"
+#include "RenderCommandList.h"
+#include "RenderQueue.h"
+#include "MockGraphics.h"
+#include "OcclusionCuller.h"
@@ -0,0 +1,176 @@
+//
+//  RenderCommandList.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_RenderCommandList_h
+#define CookieEngine_RenderCommandList_h
+
+#include "GraphicsFunctions.h"
+#include "Matrix4.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Bindings left behind by the lists replayed so far. Lists are recorded
+// without knowing what runs before them, so each one starts by binding its
+// program and vertex array; the replay drops those that change nothing.
+struct ReplayState
+{
+    static const uint32_t kUnknown = 0xFFFFFFFF;
+    
+    uint32_t program;
+    uint32_t vertexArray;
+    uint32_t commandCount;
+    uint32_t skippedCount;
+    
+    ReplayState() : program(kUnknown), vertexArray(kUnknown), commandCount(0), skippedCount(0) {}
+};
+
+// Records draw calls and the state they need as compact POD commands so
+// any thread can prepare them, and replays them later on the thread that
+// owns the graphics context. Recording makes no graphics calls. A list is
+// not thread safe, give every job its own; RenderQueue does that.
+class RenderCommandList
+{
+private:
+    enum class CommandType : uint8_t
+    {
+        Clear,
+        Viewport,
+        UseProgram,
+        Uniform,
+        BindVertexArray,
+        BindTexture,
+        BindUniformBuffer,
+        DrawArrays,
+        DrawElements,
+    };
+    
+    // Commands are packed back to back, size includes the header and any trailing values
+    struct CommandHeader
+    {
+        CommandType type;
+        uint8_t format;         // UniformType, or PrimitiveType of draws
+        uint8_t indexType;
+        uint8_t reserved;
+        uint32_t size;
+    };
+    
+    struct ClearCommand
+    {
+        CommandHeader header;
+        uint32_t flags;
+        float color[4];
+        float depth;
+    };
+    
+    struct ViewportCommand
+    {
+        CommandHeader header;
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+    };
+    
+    // UseProgram, BindVertexArray, BindTexture and BindUniformBuffer
+    struct BindCommand
+    {
+        CommandHeader header;
+        uint32_t slot;
+        uint32_t object;
+    };
+    
+    // Followed by count values
+    struct UniformCommand
+    {
+        CommandHeader header;
+        int32_t location;
+        uint32_t count;
+    };
+    
+    struct DrawCommand
+    {
+        CommandHeader header;
+        uint32_t first;
+        uint32_t count;
+        uint32_t instanceCount;
+    };
+    
+    struct Block
+    {
+        uint8_t* data;
+        uint32_t used;
+        uint32_t capacity;
+    };
+    
+    std::vector<Block> mBlocks;
+    size_t mCurrentBlock;
+    uint32_t mCommandCount;
+    
+    // Reserves size bytes for a command of type and fills in its header
+    CommandHeader* Push(CommandType type, uint32_t size);
+    
+    void PushBind(CommandType type, uint32_t slot, uint32_t object);
+    
+public:
+    RenderCommandList();
+    ~RenderCommandList();
+    
+    RenderCommandList(const RenderCommandList&) = delete;
+    RenderCommandList& operator=(const RenderCommandList&) = delete;
+    
+    // flags is a combination of ClearFlags
+    void Clear(uint32_t flags, float r, float g, float b, float a, float depth = 1.0f);
+    
+    void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height);
+    
+    // Binds program for the following uniforms and draws
+    void UseProgram(uint32_t program);
+    
+    // Sets a uniform of the current program. Look locations up on the context
+    // thread beforehand, e.g. with ShaderProgram::getUniformLocation.
+    void SetUniform(int32_t location, float x);
+    void SetUniform(int32_t location, float x, float y);
+    void SetUniform(int32_t location, float x, float y, float z);
+    void SetUniform(int32_t location, float x, float y, float z, float w);
+    void SetUniform(int32_t location, int32_t x);
+    void SetUniform(int32_t location, const Matrix4& m);
+    
+    // Copies count elements of type from values, matrices as Matrix4::Store writes them
+    void SetUniformArray(int32_t location, UniformType type, uint32_t count, const void* values);
+    
+    void BindVertexArray(uint32_t vertexArray);
+    void BindTexture(uint32_t unit, uint32_t texture);
+    void BindUniformBuffer(uint32_t binding, uint32_t buffer);
+    
+    // Draws count vertices starting at first from the bound vertex array
+    void Draw(PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount = 1);
+    
+    // Draws count indices starting at index firstIndex of the bound vertex array's index buffer
+    void DrawIndexed(PrimitiveType primitive, IndexType indexType, uint32_t firstIndex, uint32_t count,
+                     uint32_t instanceCount = 1);
+    
+    // Issues the recorded commands through functions in recording order.
+    // MUST run on the thread that owns the graphics context.
+    void Replay(const GraphicsFunctions& functions, ReplayState& state) const;
+    
+    // Forgets all commands, keeping the memory for the next frame
+    void Reset();
+    
+    __attribute__((always_inline)) bool IsEmpty() const { return mCommandCount == 0; }
+    __attribute__((always_inline)) uint32_t GetCommandCount() const { return mCommandCount; }
+    
+    // Bytes taken by the recorded commands
+    size_t GetUsedBytes() const;
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,71 @@
+//
+//  RenderQueue.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_RenderQueue_h
+#define CookieEngine_RenderQueue_h
+
+#include "RenderCommandList.h"
+
+#include <functional>
+#include <vector>
+
+namespace CookieEngine
+{
+
+class JobSystem;
+
+struct RenderQueueStats
+{
+    uint32_t listCount;
+    uint32_t commandCount;
+    uint32_t skippedCount;      // binds dropped because they were already bound
+    size_t usedBytes;
+};
+
+// Ordered set of command lists for one frame. Job threads record into lists
+// of their own without locking and Submit replays them all, in the order the
+// lists were added, on the context thread. Lists and their memory are reused
+// from frame to frame.
+class RenderQueue
+{
+private:
+    std::vector<RenderCommandList*> mLists;
+    uint32_t mUsedLists;
+    RenderQueueStats mStats;
+    
+public:
+    typedef std::function<void(RenderCommandList& list, uint32_t begin, uint32_t end)> RecordFunction;
+    
+    RenderQueue();
+    ~RenderQueue();
+    
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+    
+    // Returns an empty list that replays after all lists added before it
+    RenderCommandList& AddList();
+    
+    // Splits [0, count) into ranges of at most grainSize items and runs
+    // func(list, begin, end) for each, on jobs if it is not nullptr. Every
+    // range records into a list of its own and the lists replay in range
+    // order, so the result does not depend on which thread ran what.
+    void Record(uint32_t count, uint32_t grainSize, const RecordFunction& func, JobSystem* jobs);
+    
+    // Replays every list through functions and empties the queue. MUST run
+    // on the thread that owns the graphics context.
+    void Submit(const GraphicsFunctions& functions);
+    
+    // Empties the queue without replaying it
+    void Reset();
+    
+    // Counts of the last Submit
+    __attribute__((always_inline)) const RenderQueueStats& GetStats() const { return mStats; }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,135 @@
+//
+//  MockGraphics.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "MockGraphics.h"
+
+#include <cstring>
+
+namespace CookieEngine
+{
+
+MockGraphics::MockGraphics() : mCalls(), mValues()
+{
+}
+
+GraphicsCall& MockGraphics::AddCall(GraphicsCallType type, const void* values, uint32_t valueCount)
+{
+    GraphicsCall call;
+    memset(&call, 0, sizeof(call));
+    call.type = type;
+    call.valueOffset = (uint32_t)mValues.size();
+    call.valueCount = valueCount;
+    if(valueCount > 0)
+    {
+        mValues.resize(mValues.size() + valueCount);
+        memcpy(&mValues[call.valueOffset], values, valueCount * sizeof(float));
+    }
+    mCalls.push_back(call);
+    return mCalls.back();
+}
+
+void MockGraphics::Clear(void* context, uint32_t flags, const float* color, float depth)
+{
+    float values[5] = { color[0], color[1], color[2], color[3], depth };
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::Clear, values, 5);
+    call.args[0] = flags;
+}
+
+void MockGraphics::Viewport(void* context, int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::Viewport);
+    call.args[0] = (uint32_t)x;
+    call.args[1] = (uint32_t)y;
+    call.args[2] = (uint32_t)width;
+    call.args[3] = (uint32_t)height;
+}
+
+void MockGraphics::UseProgram(void* context, uint32_t program)
+{
+    From(context).AddCall(GraphicsCallType::UseProgram).args[0] = program;
+}
+
+void MockGraphics::Uniform(void* context, int32_t location, UniformType type, uint32_t count, const void* values)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::Uniform, values, GetUniformSize(type) * count / 4);
+    call.args[0] = (uint32_t)location;
+    call.args[1] = (uint32_t)type;
+    call.args[2] = count;
+}
+
+void MockGraphics::BindVertexArray(void* context, uint32_t vertexArray)
+{
+    From(context).AddCall(GraphicsCallType::BindVertexArray).args[0] = vertexArray;
+}
+
+void MockGraphics::BindTexture(void* context, uint32_t unit, uint32_t texture)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::BindTexture);
+    call.args[0] = unit;
+    call.args[1] = texture;
+}
+
+void MockGraphics::BindUniformBuffer(void* context, uint32_t binding, uint32_t buffer)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::BindUniformBuffer);
+    call.args[0] = binding;
+    call.args[1] = buffer;
+}
+
+void MockGraphics::DrawArrays(void* context, PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::DrawArrays);
+    call.args[0] = (uint32_t)primitive;
+    call.args[1] = first;
+    call.args[2] = count;
+    call.args[3] = instanceCount;
+}
+
+void MockGraphics::DrawElements(void* context, PrimitiveType primitive, IndexType indexType, uint32_t firstIndex,
+                                uint32_t count, uint32_t instanceCount)
+{
+    GraphicsCall& call = From(context).AddCall(GraphicsCallType::DrawElements);
+    call.args[0] = (uint32_t)primitive;
+    call.args[1] = (uint32_t)indexType;
+    call.args[2] = firstIndex;
+    call.args[3] = count;
+    call.args[4] = instanceCount;
+}
+
+GraphicsFunctions MockGraphics::GetFunctions()
+{
+    GraphicsFunctions functions;
+    functions.context = this;
+    functions.clear = Clear;
+    functions.viewport = Viewport;
+    functions.useProgram = UseProgram;
+    functions.uniform = Uniform;
+    functions.bindVertexArray = BindVertexArray;
+    functions.bindTexture = BindTexture;
+    functions.bindUniformBuffer = BindUniformBuffer;
+    functions.drawArrays = DrawArrays;
+    functions.drawElements = DrawElements;
+    return functions;
+}
+
+uint32_t MockGraphics::CountCalls(GraphicsCallType type) const
+{
+    uint32_t count = 0;
+    for(size_t i = 0; i < mCalls.size(); i++)
+    {
+        count += mCalls[i].type == type ? 1 : 0;
+    }
+    return count;
+}
+
+void MockGraphics::Reset()
+{
+    mCalls.clear();
+    mValues.clear();
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,429 @@
+//
+//  OcclusionCuller.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "OcclusionCuller.h"
+#include "RasterKernels.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace CookieEngine
+{
+
+using Detail::kTileWidth;
+using Detail::kTileHeight;
+
+// What one job rasterizes, a whole number of tiles
+static const uint32_t kBinWidth = 64;
+static const uint32_t kBinHeight = 32;
+
+// Screen triangle bounds are int16_t
+static const uint32_t kMaxSize = 32767;
+
+// Most ranges occluder setup is split into, each range keeps bin lists of its own
+static const uint32_t kMaxSetupRanges = 32;
+
+// Vertices with a smaller w are behind or too close to the eye to project
+static const float kMinW = 1e-5f;
+
+static const float kFarDepth = 1.0f;
+
+// Floats per transformed vertex: screen x, y, depth and a valid flag
+static const uint32_t kVertexFloats = 4;
+
+static bool ToScreen(const Vector3& clip, float width, float height, float* out)
+{
+    float w = clip.GetW();
+    if(w < kMinW)
+    {
+        return false;
+    }
+    
+    float inverseW = 1.0f / w;
+    out[0] = (clip.GetX() * inverseW * 0.5f + 0.5f) * width;
+    out[1] = (0.5f - clip.GetY() * inverseW * 0.5f) * height;
+    out[2] = clip.GetZ() * inverseW;
+    return out[2] >= 0.0f;
+}
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+    : mWidth(0), mHeight(0), mBinsX(0), mBinsY(0), mViewProjection(Matrix4::Identity), mOccluders(), mTiles(),
+      mTriangles(), mTriangleOffsets(), mBins(), mRangeTriangles(), mVertexScratch(), mStats()
+{
+    mBinsX = std::min(std::max((width + kBinWidth - 1) / kBinWidth, 1u), kMaxSize / kBinWidth);
+    mBinsY = std::min(std::max((height + kBinHeight - 1) / kBinHeight, 1u), kMaxSize / kBinHeight);
+    mWidth = mBinsX * kBinWidth;
+    mHeight = mBinsY * kBinHeight;
+    mTiles.resize((mWidth / kTileWidth) * (mHeight / kTileHeight));
+    mStats.simdWidth = Detail::GetRasterWidth();
+}
+
+void OcclusionCuller::BeginFrame(const Matrix4& viewProjection)
+{
+    mViewProjection = viewProjection;
+    mOccluders.clear();
+    mStats.occluderCount = 0;
+    mStats.occluderTriangles = 0;
+    mStats.rasterizedTriangles = 0;
+    mStats.testedCount = 0;
+    mStats.culledCount = 0;
+}
+
+void OcclusionCuller::AddOccluder(const float* positions, uint32_t stride, uint32_t vertexCount,
+                                  const uint32_t* indices, uint32_t triangleCount, const Matrix4& world)
+{
+    Occluder occluder;
+    occluder.transform = Concatenate(mViewProjection, world);
+    occluder.positions = positions;
+    occluder.indices = indices;
+    occluder.stride = stride;
+    occluder.vertexCount = vertexCount;
+    occluder.triangleCount = triangleCount;
+    mOccluders.push_back(occluder);
+}
+
+void OcclusionCuller::SetupOccluders(uint32_t range, uint32_t begin, uint32_t end, std::vector<float>& vertices)
+{
+    uint32_t binCount = mBinsX * mBinsY;
+    std::vector<uint32_t>* bins = &mBins[range * binCount];
+    float width = (float)mWidth;
+    float height = (float)mHeight;
+    uint32_t rasterized = 0;
+    
+    for(uint32_t o = begin; o < end; o++)
+    {
+        const Occluder& occluder = mOccluders[o];
+        
+        // Every vertex is transformed once, however many triangles share it
+        vertices.resize(occluder.vertexCount * kVertexFloats);
+        const uint8_t* position = (const uint8_t*)occluder.positions;
+        for(uint32_t v = 0; v < occluder.vertexCount; v++, position += occluder.stride)
+        {
+            const float* p = (const float*)position;
+            float* out = &vertices[v * kVertexFloats];
+            out[3] = ToScreen(occluder.transform * Vector3(p[0], p[1], p[2]), width, height, out) ? 1.0f : 0.0f;
+        }
+        
+        for(uint32_t t = 0; t < occluder.triangleCount; t++)
+        {
+            const uint32_t* index = &occluder.indices[t * 3];
+            if(index[0] >= occluder.vertexCount || index[1] >= occluder.vertexCount || index[2] >= occluder.vertexCount)
+            {
+                continue;
+            }
+            
+            // A triangle crossing the near plane would need clipping, dropping it only lets more through
+            const float* v0 = &vertices[index[0] * kVertexFloats];
+            const float* v1 = &vertices[index[1] * kVertexFloats];
+            const float* v2 = &vertices[index[2] * kVertexFloats];
+            if(v0[3] == 0.0f || v1[3] == 0.0f || v2[3] == 0.0f)
+            {
+                continue;
+            }
+            
+            // Clamped as floats first, w close to zero throws x and y far outside int range
+            int32_t minX = (int32_t)std::floor(std::max(std::min(v0[0], std::min(v1[0], v2[0])), 0.0f));
+            int32_t minY = (int32_t)std::floor(std::max(std::min(v0[1], std::min(v1[1], v2[1])), 0.0f));
+            int32_t maxX = (int32_t)std::ceil(std::min(std::max(v0[0], std::max(v1[0], v2[0])), width));
+            int32_t maxY = (int32_t)std::ceil(std::min(std::max(v0[1], std::max(v1[1], v2[1])), height));
+            if(minX >= maxX || minY >= maxY)
+            {
+                continue;
+            }
+            
+            float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+            if(std::fabs(area) < 1e-6f)
+            {
+                continue;
+            }
+            
+            // Edge i is the one opposite vertex i, flipped so the inside is positive for both windings
+            Detail::ScreenTriangle& triangle = mTriangles[mTriangleOffsets[o] + t];
+            const float* edgeStart[3] = { v1, v2, v0 };
+            const float* edgeEnd[3] = { v2, v0, v1 };
+            float sign = area > 0.0f ? 1.0f : -1.0f;
+            for(int e = 0; e < 3; e++)
+            {
+                const float* a = edgeStart[e];
+                const float* b = edgeEnd[e];
+                triangle.edgeA[e] = (a[1] - b[1]) * sign;
+                triangle.edgeB[e] = (b[0] - a[0]) * sign;
+                triangle.edgeC[e] = (a[0] * b[1] - b[0] * a[1]) * sign;
+            }
+            
+            // Depth from barycentrics, edge 1 over the area weighs vertex 1 and edge 2 vertex 2
+            float inverseArea = 1.0f / std::fabs(area);
+            float dz1 = (v1[2] - v0[2]) * inverseArea;
+            float dz2 = (v2[2] - v0[2]) * inverseArea;
+            triangle.depthA = triangle.edgeA[1] * dz1 + triangle.edgeA[2] * dz2;
+            triangle.depthB = triangle.edgeB[1] * dz1 + triangle.edgeB[2] * dz2;
+            triangle.depthC = triangle.edgeC[1] * dz1 + triangle.edgeC[2] * dz2 + v0[2];
+            triangle.maxDepth = std::max(v0[2], std::max(v1[2], v2[2]));
+            triangle.minX = (int16_t)minX;
+            triangle.minY = (int16_t)minY;
+            triangle.maxX = (int16_t)maxX;
+            triangle.maxY = (int16_t)maxY;
+            
+            uint32_t binMaxX = (uint32_t)(maxX - 1) / kBinWidth;
+            uint32_t binMaxY = (uint32_t)(maxY - 1) / kBinHeight;
+            for(uint32_t y = (uint32_t)minY / kBinHeight; y <= binMaxY; y++)
+            {
+                for(uint32_t x = (uint32_t)minX / kBinWidth; x <= binMaxX; x++)
+                {
+                    bins[y * mBinsX + x].push_back(mTriangleOffsets[o] + t);
+                }
+            }
+            rasterized++;
+        }
+    }
+    
+    mRangeTriangles[range] = rasterized;
+}
+
+void OcclusionCuller::RasterizeBin(uint32_t bin, uint32_t rangeCount)
+{
+    uint32_t binCount = mBinsX * mBinsY;
+    Detail::RasterRect rect;
+    rect.tiles = mTiles.data();
+    rect.stride = mWidth / kTileWidth;
+    rect.minX = (int32_t)((bin % mBinsX) * kBinWidth);
+    rect.minY = (int32_t)((bin / mBinsX) * kBinHeight);
+    rect.maxX = rect.minX + (int32_t)kBinWidth;
+    rect.maxY = rect.minY + (int32_t)kBinHeight;
+    
+    // Nothing in the working layer and the far plane behind the rest
+    Detail::MaskedTile empty;
+    empty.mask = 0;
+    empty.z0 = kFarDepth;
+    empty.z1 = 0.0f;
+    for(int32_t y = rect.minY; y < rect.maxY; y += kTileHeight)
+    {
+        Detail::MaskedTile* row = &mTiles[(y / kTileHeight) * rect.stride];
+        std::fill(row + rect.minX / kTileWidth, row + rect.maxX / kTileWidth, empty);
+    }
+    
+    Detail::RasterizeFunction rasterize = Detail::GetRasterizeFunction();
+    for(uint32_t r = 0; r < rangeCount; r++)
+    {
+        const std::vector<uint32_t>& triangles = mBins[r * binCount + bin];
+        if(!triangles.empty())
+        {
+            rasterize(mTriangles.data(), triangles.data(), (uint32_t)triangles.size(), rect);
+        }
+    }
+}
+
+void OcclusionCuller::RasterizeOccluders(JobSystem* jobs)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    
+    uint32_t occluderCount = (uint32_t)mOccluders.size();
+    mTriangleOffsets.resize(occluderCount);
+    uint32_t triangleCount = 0;
+    for(uint32_t o = 0; o < occluderCount; o++)
+    {
+        mTriangleOffsets[o] = triangleCount;
+        triangleCount += mOccluders[o].triangleCount;
+    }
+    mTriangles.resize(triangleCount);
+    
+    // Bin lists keep their capacity from frame to frame
+    uint32_t binCount = mBinsX * mBinsY;
+    uint32_t grainSize = std::max((occluderCount + kMaxSetupRanges - 1) / kMaxSetupRanges, 1u);
+    uint32_t rangeCount = (occluderCount + grainSize - 1) / grainSize;
+    if(mBins.size() < rangeCount * binCount)
+    {
+        mBins.resize(rangeCount * binCount);
+    }
+    for(size_t i = 0; i < mBins.size(); i++)
+    {
+        mBins[i].clear();
+    }
+    mRangeTriangles.assign(rangeCount, 0);
+    
+    uint32_t threadCount = jobs ? jobs->GetThreadCount() : 1;
+    if(mVertexScratch.size() < threadCount)
+    {
+        mVertexScratch.resize(threadCount);
+    }
+    
+    if(jobs && rangeCount > 1)
+    {
+        jobs->ParallelFor(occluderCount, grainSize, [&](uint32_t begin, uint32_t end)
+        {
+            SetupOccluders(begin / grainSize, begin, end, mVertexScratch[JobSystem::GetThreadIndex()]);
+        });
+    }
+    else
+    {
+        for(uint32_t r = 0; r < rangeCount; r++)
+        {
+            uint32_t begin = r * grainSize;
+            SetupOccluders(r, begin, std::min(begin + grainSize, occluderCount), mVertexScratch[0]);
+        }
+    }
+    
+    // Bins do not overlap, so each job owns the tiles it writes
+    if(jobs)
+    {
+        jobs->ParallelFor(binCount, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for(uint32_t bin = begin; bin < end; bin++)
+            {
+                RasterizeBin(bin, rangeCount);
+            }
+        });
+    }
+    else
+    {
+        for(uint32_t bin = 0; bin < binCount; bin++)
+        {
+            RasterizeBin(bin, rangeCount);
+        }
+    }
+    
+    mStats.occluderCount = occluderCount;
+    mStats.occluderTriangles = triangleCount;
+    mStats.rasterizedTriangles = 0;
+    for(uint32_t r = 0; r < rangeCount; r++)
+    {
+        mStats.rasterizedTriangles += mRangeTriangles[r];
+    }
+    mStats.rasterizeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool OcclusionCuller::IsRectVisible(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float depth) const
+{
+    uint32_t tilesX = mWidth / kTileWidth;
+    int32_t tileMinX = minX / (int32_t)kTileWidth;
+    int32_t tileMinY = minY / (int32_t)kTileHeight;
+    int32_t tileMaxX = (maxX - 1) / (int32_t)kTileWidth;
+    int32_t tileMaxY = (maxY - 1) / (int32_t)kTileHeight;
+    
+    for(int32_t ty = tileMinY; ty <= tileMaxY; ty++)
+    {
+        // Rows of the tile inside the rectangle, 8 mask bits each
+        int32_t y = ty * (int32_t)kTileHeight;
+        int32_t rowBegin = std::max(minY - y, 0);
+        int32_t rowEnd = std::min(maxY - y, (int32_t)kTileHeight);
+        uint32_t rows = (0xFFFFFFFFu >> (32 - (rowEnd - rowBegin) * kTileWidth)) << (rowBegin * kTileWidth);
+        
+        for(int32_t tx = tileMinX; tx <= tileMaxX; tx++)
+        {
+            // Both layers nearer than the box hide it
+            const Detail::MaskedTile& tile = mTiles[ty * tilesX + tx];
+            if(tile.z0 < depth)
+            {
+                continue;
+            }
+            
+            // Only the working layer is, so it has to cover every pixel of the rectangle in the tile
+            if(tile.z1 < depth)
+            {
+                int32_t x = tx * (int32_t)kTileWidth;
+                int32_t columnBegin = std::max(minX - x, 0);
+                int32_t columnEnd = std::min(maxX - x, (int32_t)kTileWidth);
+                uint32_t columns = ((0xFFu >> (kTileWidth - (columnEnd - columnBegin))) << columnBegin) * 0x01010101u;
+                if((rows & columns & ~tile.mask) == 0)
+                {
+                    continue;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OcclusionCuller::IsVisible(const Vector3& min, const Vector3& max) const
+{
+    float minX = 1e30f;
+    float minY = 1e30f;
+    float maxX = -1e30f;
+    float maxY = -1e30f;
+    float nearest = 1e30f;
+    float width = (float)mWidth;
+    float height = (float)mHeight;
+    int nearCount = 0;
+    
+    for(int i = 0; i < 8; i++)
+    {
+        Vector3 corner((i & 1) ? max.GetX() : min.GetX(), (i & 2) ? max.GetY() : min.GetY(), (i & 4) ? max.GetZ() : min.GetZ());
+        float screen[3];
+        if(!ToScreen(mViewProjection * corner, width, height, screen))
+        {
+            nearCount++;
+            continue;
+        }
+        minX = std::min(minX, screen[0]);
+        minY = std::min(minY, screen[1]);
+        maxX = std::max(maxX, screen[0]);
+        maxY = std::max(maxY, screen[1]);
+        nearest = std::min(nearest, screen[2]);
+    }
+    
+    // Wholly on the near side of the near plane draws nothing, partly could draw anything
+    if(nearCount == 8)
+    {
+        return false;
+    }
+    if(nearCount > 0)
+    {
+        return true;
+    }
+    
+    // Off screen or past the far plane
+    if(maxX <= 0.0f || maxY <= 0.0f || minX >= width || minY >= height || nearest > kFarDepth)
+    {
+        return false;
+    }
+    
+    int32_t rectMinX = (int32_t)std::floor(std::max(minX, 0.0f));
+    int32_t rectMinY = (int32_t)std::floor(std::max(minY, 0.0f));
+    int32_t rectMaxX = (int32_t)std::ceil(std::min(maxX, width));
+    int32_t rectMaxY = (int32_t)std::ceil(std::min(maxY, height));
+    if(rectMinX >= rectMaxX || rectMinY >= rectMaxY)
+    {
+        return false;
+    }
+    return IsRectVisible(rectMinX, rectMinY, rectMaxX, rectMaxY, nearest);
+}
+
+void OcclusionCuller::TestVisibility(const Vector3* mins, const Vector3* maxs, uint32_t count, bool* visible, JobSystem* jobs)
+{
+    static const uint32_t kGrainSize = 64;
+    
+    if(jobs && count > kGrainSize)
+    {
+        jobs->ParallelFor(count, kGrainSize, [&](uint32_t begin, uint32_t end)
+        {
+            for(uint32_t i = begin; i < end; i++)
+            {
+                visible[i] = IsVisible(mins[i], maxs[i]);
+            }
+        });
+    }
+    else
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            visible[i] = IsVisible(mins[i], maxs[i]);
+        }
+    }
+    
+    uint32_t culled = 0;
+    for(uint32_t i = 0; i < count; i++)
+    {
+        culled += visible[i] ? 0 : 1;
+    }
+    mStats.testedCount += count;
+    mStats.culledCount += culled;
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,207 @@
+//
+//  RasterKernels.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "RasterKernels.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+namespace
+{
+    static const uint32_t kFullMask = 0xFFFFFFFFu;
+    
+    // Clips the bounds of triangle to rect and widens them to whole tiles. Returns false if nothing is left.
+    __attribute__((always_inline)) inline bool ClipBounds(const ScreenTriangle& triangle, const RasterRect& rect,
+                                                          int32_t& minX, int32_t& minY, int32_t& maxX, int32_t& maxY)
+    {
+        minX = std::max((int32_t)triangle.minX, rect.minX) & ~(int32_t)(kTileWidth - 1);
+        minY = std::max((int32_t)triangle.minY, rect.minY) & ~(int32_t)(kTileHeight - 1);
+        maxX = std::min((int32_t)triangle.maxX, rect.maxX);
+        maxY = std::min((int32_t)triangle.maxY, rect.maxY);
+        return minX < maxX && minY < maxY;
+    }
+    
+    // Farthest depth of triangle at the pixel centers of the tile at x, y. The
+    // plane only goes past the farthest vertex outside the triangle.
+    __attribute__((always_inline)) inline float GetTileDepth(const ScreenTriangle& triangle, int32_t x, int32_t y)
+    {
+        float px = (float)x + (triangle.depthA > 0.0f ? kTileWidth - 0.5f : 0.5f);
+        float py = (float)y + (triangle.depthB > 0.0f ? kTileHeight - 0.5f : 0.5f);
+        return std::min(triangle.depthA * px + triangle.depthB * py + triangle.depthC, triangle.maxDepth);
+    }
+    
+    // Merges the pixels in coverage, none farther than depth, into the working
+    // layer of tile. A full working layer becomes the reference layer. When the
+    // triangle is nearer to the working layer than the working layer is to the
+    // reference one, the working layer starts over from the triangle, so a near
+    // occluder is not lost to the far ones the tile already holds.
+    __attribute__((always_inline)) inline void UpdateTile(MaskedTile& tile, uint32_t coverage, float depth)
+    {
+        bool discard = coverage == kFullMask || 2.0f * tile.z1 > depth + tile.z0;
+        uint32_t mask = (discard ? 0 : tile.mask) | coverage;
+        float z1 = discard ? depth : std::max(tile.z1, depth);
+        if(mask == kFullMask)
+        {
+            tile.mask = 0;
+            tile.z0 = z1;
+            tile.z1 = 0.0f;
+        }
+        else
+        {
+            tile.mask = mask;
+            tile.z1 = z1;
+        }
+    }
+    
+    void RasterizeSse(const ScreenTriangle* triangles, const uint32_t* indices, uint32_t count, const RasterRect& rect)
+    {
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        
+        for(uint32_t t = 0; t < count; t++)
+        {
+            const ScreenTriangle& triangle = triangles[indices[t]];
+            int32_t minX, minY, maxX, maxY;
+            if(!ClipBounds(triangle, rect, minX, minY, maxX, maxY))
+            {
+                continue;
+            }
+            
+            __m128 a0 = _mm_set_ps1(triangle.edgeA[0]);
+            __m128 a1 = _mm_set_ps1(triangle.edgeA[1]);
+            __m128 a2 = _mm_set_ps1(triangle.edgeA[2]);
+            
+            for(int32_t y = minY; y < maxY; y += kTileHeight)
+            {
+                // Everything that is constant along a row of tiles
+                __m128 c0[kTileHeight];
+                __m128 c1[kTileHeight];
+                __m128 c2[kTileHeight];
+                for(uint32_t row = 0; row < kTileHeight; row++)
+                {
+                    float py = (float)(y + (int32_t)row) + 0.5f;
+                    c0[row] = _mm_set_ps1(triangle.edgeB[0] * py + triangle.edgeC[0]);
+                    c1[row] = _mm_set_ps1(triangle.edgeB[1] * py + triangle.edgeC[1]);
+                    c2[row] = _mm_set_ps1(triangle.edgeB[2] * py + triangle.edgeC[2]);
+                }
+                MaskedTile* tile = rect.tiles + (y / kTileHeight) * rect.stride + minX / kTileWidth;
+                
+                for(int32_t x = minX; x < maxX; x += kTileWidth, tile++)
+                {
+                    float depth = GetTileDepth(triangle, x, y);
+                    if(depth > tile->z0)
+                    {
+                        continue;
+                    }
+                    
+                    // Inside if no edge function is negative, the sign bits say it all
+                    uint32_t coverage = 0;
+                    for(uint32_t half = 0; half < 2; half++)
+                    {
+                        __m128 px = _mm_add_ps(_mm_set_ps1((float)(x + 4 * (int32_t)half)), laneOffsets);
+                        __m128 ax0 = _mm_mul_ps(a0, px);
+                        __m128 ax1 = _mm_mul_ps(a1, px);
+                        __m128 ax2 = _mm_mul_ps(a2, px);
+                        for(uint32_t row = 0; row < kTileHeight; row++)
+                        {
+                            __m128 outside = _mm_or_ps(_mm_add_ps(ax0, c0[row]),
+                                                       _mm_or_ps(_mm_add_ps(ax1, c1[row]), _mm_add_ps(ax2, c2[row])));
+                            coverage |= (uint32_t)(~_mm_movemask_ps(outside) & 0xF) << (row * kTileWidth + half * 4);
+                        }
+                    }
+                    if(coverage)
+                    {
+                        UpdateTile(*tile, coverage, depth);
+                    }
+                }
+            }
+        }
+    }
+    
+    __attribute__((target("avx2,fma")))
+    void RasterizeAvx2(const ScreenTriangle* triangles, const uint32_t* indices, uint32_t count, const RasterRect& rect)
+    {
+        const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        
+        for(uint32_t t = 0; t < count; t++)
+        {
+            const ScreenTriangle& triangle = triangles[indices[t]];
+            int32_t minX, minY, maxX, maxY;
+            if(!ClipBounds(triangle, rect, minX, minY, maxX, maxY))
+            {
+                continue;
+            }
+            
+            __m256 a0 = _mm256_set1_ps(triangle.edgeA[0]);
+            __m256 a1 = _mm256_set1_ps(triangle.edgeA[1]);
+            __m256 a2 = _mm256_set1_ps(triangle.edgeA[2]);
+            
+            for(int32_t y = minY; y < maxY; y += kTileHeight)
+            {
+                __m256 c0[kTileHeight];
+                __m256 c1[kTileHeight];
+                __m256 c2[kTileHeight];
+                for(uint32_t row = 0; row < kTileHeight; row++)
+                {
+                    float py = (float)(y + (int32_t)row) + 0.5f;
+                    c0[row] = _mm256_set1_ps(triangle.edgeB[0] * py + triangle.edgeC[0]);
+                    c1[row] = _mm256_set1_ps(triangle.edgeB[1] * py + triangle.edgeC[1]);
+                    c2[row] = _mm256_set1_ps(triangle.edgeB[2] * py + triangle.edgeC[2]);
+                }
+                MaskedTile* tile = rect.tiles + (y / kTileHeight) * rect.stride + minX / kTileWidth;
+                
+                for(int32_t x = minX; x < maxX; x += kTileWidth, tile++)
+                {
+                    float depth = GetTileDepth(triangle, x, y);
+                    if(depth > tile->z0)
+                    {
+                        continue;
+                    }
+                    
+                    // One row of the tile per step
+                    __m256 px = _mm256_add_ps(_mm256_set1_ps((float)x), laneOffsets);
+                    uint32_t coverage = 0;
+                    for(uint32_t row = 0; row < kTileHeight; row++)
+                    {
+                        __m256 outside = _mm256_or_ps(_mm256_fmadd_ps(a0, px, c0[row]),
+                                                      _mm256_or_ps(_mm256_fmadd_ps(a1, px, c1[row]),
+                                                                   _mm256_fmadd_ps(a2, px, c2[row])));
+                        coverage |= (uint32_t)(~_mm256_movemask_ps(outside) & 0xFF) << (row * kTileWidth);
+                    }
+                    if(coverage)
+                    {
+                        UpdateTile(*tile, coverage, depth);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Kept out of Detail, the particle kernels export a HasAvx2 of their own
+    bool HasAvx2Fma()
+    {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+} // namespace
+
+RasterizeFunction GetRasterizeFunction()
+{
+    static const RasterizeFunction rasterize = HasAvx2Fma() ? RasterizeAvx2 : RasterizeSse;
+    return rasterize;
+}
+
+uint32_t GetRasterWidth()
+{
+    return GetRasterizeFunction() == RasterizeAvx2 ? 8 : 4;
+}
+
+} // namespace Detail
+} // namespace CookieEngine
@@ -0,0 +1,47 @@
+//
+//  RasterKernels.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_RasterKernels_h
+#define CookieEngine_RasterKernels_h
+
+#include "OcclusionCuller.h"
+
+namespace CookieEngine
+{
+namespace Detail
+{
+
+// Pixels per tile, one bit of MaskedTile::mask each
+static const uint32_t kTileWidth = 8;
+static const uint32_t kTileHeight = 4;
+
+// Pixel rectangle [minX, maxX) x [minY, maxY) of a buffer of stride tiles per
+// row. The rectangle is made of whole tiles.
+struct RasterRect
+{
+    MaskedTile* tiles;
+    uint32_t stride;
+    int32_t minX;
+    int32_t minY;
+    int32_t maxX;
+    int32_t maxY;
+};
+
+// Rasterizes triangles[indices[i]] into the tiles of rect
+typedef void (*RasterizeFunction)(const ScreenTriangle* triangles, const uint32_t* indices, uint32_t count,
+                                  const RasterRect& rect);
+
+// Returns the AVX2 rasterizer if the CPU runs it and the SSE4.1 one otherwise
+RasterizeFunction GetRasterizeFunction();
+
+// Lanes the chosen rasterizer covers per step, 8 or 4
+uint32_t GetRasterWidth();
+
+} // namespace Detail
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,292 @@
+//
+//  RenderCommandList.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "RenderCommandList.h"
+#include "Allocator.h"
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace CookieEngine
+{
+
+static const uint32_t kRenderBlockSize = 16 * 1024;
+
+// Every command and every uniform value is 4 byte aligned
+static const uint32_t kRenderCommandAlignment = 4;
+
+RenderCommandList::RenderCommandList() : mBlocks(), mCurrentBlock(0), mCommandCount(0)
+{
+    static_assert(std::is_trivially_copyable<ClearCommand>::value && std::is_trivially_copyable<DrawCommand>::value,
+                  "Render commands must be POD");
+}
+
+RenderCommandList::~RenderCommandList()
+{
+    for(size_t i = 0; i < mBlocks.size(); i++)
+    {
+        AlignedFree(mBlocks[i].data);
+    }
+}
+
+RenderCommandList::CommandHeader* RenderCommandList::Push(CommandType type, uint32_t size)
+{
+    size = (uint32_t)AlignUp(size, kRenderCommandAlignment);
+    while(mCurrentBlock < mBlocks.size() && mBlocks[mCurrentBlock].used + size > mBlocks[mCurrentBlock].capacity)
+    {
+        mCurrentBlock++;
+    }
+    
+    if(mCurrentBlock == mBlocks.size())
+    {
+        Block block;
+        block.capacity = size > kRenderBlockSize ? (uint32_t)AlignUp(size, 64) : kRenderBlockSize;
+        block.used = 0;
+        block.data = static_cast<uint8_t*>(AlignedMalloc(block.capacity, 64));
+        assert(block.data != nullptr && "Out of memory");
+        mBlocks.push_back(block);
+    }
+    
+    Block& block = mBlocks[mCurrentBlock];
+    CommandHeader* header = reinterpret_cast<CommandHeader*>(block.data + block.used);
+    header->type = type;
+    header->format = 0;
+    header->indexType = 0;
+    header->reserved = 0;
+    header->size = size;
+    
+    block.used += size;
+    mCommandCount++;
+    return header;
+}
+
+void RenderCommandList::PushBind(CommandType type, uint32_t slot, uint32_t object)
+{
+    BindCommand* command = reinterpret_cast<BindCommand*>(Push(type, sizeof(BindCommand)));
+    command->slot = slot;
+    command->object = object;
+}
+
+void RenderCommandList::Clear(uint32_t flags, float r, float g, float b, float a, float depth)
+{
+    ClearCommand* command = reinterpret_cast<ClearCommand*>(Push(CommandType::Clear, sizeof(ClearCommand)));
+    command->flags = flags;
+    command->color[0] = r;
+    command->color[1] = g;
+    command->color[2] = b;
+    command->color[3] = a;
+    command->depth = depth;
+}
+
+void RenderCommandList::SetViewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    ViewportCommand* command = reinterpret_cast<ViewportCommand*>(Push(CommandType::Viewport, sizeof(ViewportCommand)));
+    command->x = x;
+    command->y = y;
+    command->width = width;
+    command->height = height;
+}
+
+void RenderCommandList::UseProgram(uint32_t program)
+{
+    PushBind(CommandType::UseProgram, 0, program);
+}
+
+void RenderCommandList::SetUniform(int32_t location, float x)
+{
+    SetUniformArray(location, UniformType::Float, 1, &x);
+}
+
+void RenderCommandList::SetUniform(int32_t location, float x, float y)
+{
+    float values[2] = { x, y };
+    SetUniformArray(location, UniformType::Float2, 1, values);
+}
+
+void RenderCommandList::SetUniform(int32_t location, float x, float y, float z)
+{
+    float values[3] = { x, y, z };
+    SetUniformArray(location, UniformType::Float3, 1, values);
+}
+
+void RenderCommandList::SetUniform(int32_t location, float x, float y, float z, float w)
+{
+    float values[4] = { x, y, z, w };
+    SetUniformArray(location, UniformType::Float4, 1, values);
+}
+
+void RenderCommandList::SetUniform(int32_t location, int32_t x)
+{
+    SetUniformArray(location, UniformType::Int, 1, &x);
+}
+
+void RenderCommandList::SetUniform(int32_t location, const Matrix4& m)
+{
+    UniformCommand* command = reinterpret_cast<UniformCommand*>(Push(CommandType::Uniform, sizeof(UniformCommand) + 64));
+    command->header.format = (uint8_t)UniformType::Matrix4;
+    command->location = location;
+    command->count = 1;
+    
+    // Straight from the registers into the list, Matrix4::Store needs no alignment
+    m.Store(reinterpret_cast<float*>(command + 1));
+}
+
+void RenderCommandList::SetUniformArray(int32_t location, UniformType type, uint32_t count, const void* values)
+{
+    uint32_t bytes = GetUniformSize(type) * count;
+    UniformCommand* command = reinterpret_cast<UniformCommand*>(Push(CommandType::Uniform, sizeof(UniformCommand) + bytes));
+    command->header.format = (uint8_t)type;
+    command->location = location;
+    command->count = count;
+    memcpy(command + 1, values, bytes);
+}
+
+void RenderCommandList::BindVertexArray(uint32_t vertexArray)
+{
+    PushBind(CommandType::BindVertexArray, 0, vertexArray);
+}
+
+void RenderCommandList::BindTexture(uint32_t unit, uint32_t texture)
+{
+    PushBind(CommandType::BindTexture, unit, texture);
+}
+
+void RenderCommandList::BindUniformBuffer(uint32_t binding, uint32_t buffer)
+{
+    PushBind(CommandType::BindUniformBuffer, binding, buffer);
+}
+
+void RenderCommandList::Draw(PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount)
+{
+    DrawCommand* command = reinterpret_cast<DrawCommand*>(Push(CommandType::DrawArrays, sizeof(DrawCommand)));
+    command->header.format = (uint8_t)primitive;
+    command->first = first;
+    command->count = count;
+    command->instanceCount = instanceCount;
+}
+
+void RenderCommandList::DrawIndexed(PrimitiveType primitive, IndexType indexType, uint32_t firstIndex, uint32_t count,
+                                    uint32_t instanceCount)
+{
+    DrawCommand* command = reinterpret_cast<DrawCommand*>(Push(CommandType::DrawElements, sizeof(DrawCommand)));
+    command->header.format = (uint8_t)primitive;
+    command->header.indexType = (uint8_t)indexType;
+    command->first = firstIndex;
+    command->count = count;
+    command->instanceCount = instanceCount;
+}
+
+void RenderCommandList::Replay(const GraphicsFunctions& functions, ReplayState& state) const
+{
+    void* context = functions.context;
+    for(size_t b = 0; b < mBlocks.size(); b++)
+    {
+        const Block& block = mBlocks[b];
+        uint32_t offset = 0;
+        while(offset < block.used)
+        {
+            const CommandHeader* header = reinterpret_cast<const CommandHeader*>(block.data + offset);
+            switch(header->type)
+            {
+                case CommandType::Clear:
+                {
+                    const ClearCommand* command = reinterpret_cast<const ClearCommand*>(header);
+                    functions.clear(context, command->flags, command->color, command->depth);
+                    break;
+                }
+                case CommandType::Viewport:
+                {
+                    const ViewportCommand* command = reinterpret_cast<const ViewportCommand*>(header);
+                    functions.viewport(context, command->x, command->y, command->width, command->height);
+                    break;
+                }
+                case CommandType::UseProgram:
+                {
+                    const BindCommand* command = reinterpret_cast<const BindCommand*>(header);
+                    if(command->object == state.program)
+                    {
+                        state.skippedCount++;
+                        break;
+                    }
+                    functions.useProgram(context, command->object);
+                    state.program = command->object;
+                    break;
+                }
+                case CommandType::Uniform:
+                {
+                    const UniformCommand* command = reinterpret_cast<const UniformCommand*>(header);
+                    functions.uniform(context, command->location, (UniformType)header->format, command->count, command + 1);
+                    break;
+                }
+                case CommandType::BindVertexArray:
+                {
+                    const BindCommand* command = reinterpret_cast<const BindCommand*>(header);
+                    if(command->object == state.vertexArray)
+                    {
+                        state.skippedCount++;
+                        break;
+                    }
+                    functions.bindVertexArray(context, command->object);
+                    state.vertexArray = command->object;
+                    break;
+                }
+                case CommandType::BindTexture:
+                {
+                    const BindCommand* command = reinterpret_cast<const BindCommand*>(header);
+                    functions.bindTexture(context, command->slot, command->object);
+                    break;
+                }
+                case CommandType::BindUniformBuffer:
+                {
+                    const BindCommand* command = reinterpret_cast<const BindCommand*>(header);
+                    functions.bindUniformBuffer(context, command->slot, command->object);
+                    break;
+                }
+                case CommandType::DrawArrays:
+                {
+                    const DrawCommand* command = reinterpret_cast<const DrawCommand*>(header);
+                    functions.drawArrays(context, (PrimitiveType)header->format, command->first, command->count,
+                                         command->instanceCount);
+                    break;
+                }
+                case CommandType::DrawElements:
+                {
+                    const DrawCommand* command = reinterpret_cast<const DrawCommand*>(header);
+                    functions.drawElements(context, (PrimitiveType)header->format, (IndexType)header->indexType,
+                                           command->first, command->count, command->instanceCount);
+                    break;
+                }
+            }
+            
+            offset += header->size;
+        }
+    }
+    state.commandCount += mCommandCount;
+}
+
+void RenderCommandList::Reset()
+{
+    for(size_t b = 0; b < mBlocks.size(); b++)
+    {
+        mBlocks[b].used = 0;
+    }
+    mCurrentBlock = 0;
+    mCommandCount = 0;
+}
+
+size_t RenderCommandList::GetUsedBytes() const
+{
+    size_t bytes = 0;
+    for(size_t b = 0; b < mBlocks.size(); b++)
+    {
+        bytes += mBlocks[b].used;
+    }
+    return bytes;
+}
+
+} // namespace CookieEngine
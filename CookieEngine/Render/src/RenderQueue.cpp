@@ -0,0 +1,95 @@
+//
+//  RenderQueue.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "RenderQueue.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace CookieEngine
+{
+
+RenderQueue::RenderQueue() : mLists(), mUsedLists(0), mStats()
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+    for(size_t i = 0; i < mLists.size(); i++)
+    {
+        delete mLists[i];
+    }
+}
+
+RenderCommandList& RenderQueue::AddList()
+{
+    if(mUsedLists == mLists.size())
+    {
+        mLists.push_back(new RenderCommandList());
+    }
+    return *mLists[mUsedLists++];
+}
+
+void RenderQueue::Record(uint32_t count, uint32_t grainSize, const RecordFunction& func, JobSystem* jobs)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    
+    // Lists are handed out up front, the jobs only index them
+    uint32_t rangeCount = (count + grainSize - 1) / grainSize;
+    uint32_t firstList = mUsedLists;
+    for(uint32_t r = 0; r < rangeCount; r++)
+    {
+        AddList();
+    }
+    
+    if(jobs && rangeCount > 1)
+    {
+        jobs->ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end)
+        {
+            func(*mLists[firstList + begin / grainSize], begin, end);
+        });
+    }
+    else
+    {
+        for(uint32_t r = 0; r < rangeCount; r++)
+        {
+            uint32_t begin = r * grainSize;
+            func(*mLists[firstList + r], begin, std::min(begin + grainSize, count));
+        }
+    }
+}
+
+void RenderQueue::Submit(const GraphicsFunctions& functions)
+{
+    ReplayState state;
+    size_t usedBytes = 0;
+    for(uint32_t i = 0; i < mUsedLists; i++)
+    {
+        mLists[i]->Replay(functions, state);
+        usedBytes += mLists[i]->GetUsedBytes();
+    }
+    
+    mStats.listCount = mUsedLists;
+    mStats.commandCount = state.commandCount;
+    mStats.skippedCount = state.skippedCount;
+    mStats.usedBytes = usedBytes;
+    Reset();
+}
+
+void RenderQueue::Reset()
+{
+    for(uint32_t i = 0; i < mUsedLists; i++)
+    {
+        mLists[i]->Reset();
+    }
+    mUsedLists = 0;
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,57 @@
+//
+//  FileReader.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_FileReader_h
+#define CookieEngine_FileReader_h
+
+#include <cstddef>
+#include <string>
+
+// io_uring is used when liburing is available, define COOKIE_USE_IO_URING to 0 to force pread
+#ifndef COOKIE_USE_IO_URING
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<liburing.h>)
+#define COOKIE_USE_IO_URING 1
+#endif
+#endif
+#endif
+#ifndef COOKIE_USE_IO_URING
+#define COOKIE_USE_IO_URING 0
+#endif
+
+namespace CookieEngine
+{
+
+// Reads whole files into aligned staging memory. Large files are split into
+// chunks that are kept in flight together on io_uring, or read one after
+// another with pread. Each I/O thread owns one FileReader.
+class FileReader
+{
+private:
+    void* mRing;
+    
+    bool ReadWithPread(int fd, unsigned char* data, size_t size, size_t fileOffset);
+    bool ReadWithIoUring(int fd, unsigned char* data, size_t size);
+    
+public:
+    // Sets up an io_uring if the build and the kernel support it
+    FileReader();
+    ~FileReader();
+    
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+    
+    // Reads path into memory from AlignedMalloc, free it with AlignedFree
+    bool Read(const std::string& path, void*& data, size_t& size, std::string& error);
+    
+    // False from the start without io_uring, and after a failed submit leaves reads stuck in the ring
+    __attribute__((always_inline)) bool UsesIoUring() const { return mRing != nullptr; }
+};
+
+} // namespace CookieEngine
+
+#endif
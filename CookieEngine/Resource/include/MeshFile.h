@@ -0,0 +1,72 @@
+//
+//  MeshFile.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_MeshFile_h
+#define CookieEngine_MeshFile_h
+
+#include "MeshFormat.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <string>
+
+namespace CookieEngine
+{
+
+// Read-only view of a .cmesh file. The file is memory mapped, so opening it
+// does no parsing or copying; the vertex and index pointers point straight
+// into the mapping and stay valid until Close.
+class MeshFile
+{
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    bool mMapped;
+    std::string mErrorLog;
+    
+    bool Validate();
+    
+public:
+    MeshFile();
+    ~MeshFile();
+    
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+    
+    // Maps filename, returns false and fills the error log if it is not a valid mesh
+    bool Open(const std::string& filename);
+    
+    // Maps a mesh that already lives in memory (e.g. a staging buffer). data MUST outlive this object.
+    bool OpenFromMemory(const void* data, size_t size);
+    
+    // Unmaps the file
+    void Close();
+    
+    __attribute__((always_inline)) bool IsOpen() const { return mData != nullptr; }
+    
+    __attribute__((always_inline)) const MeshFileHeader& GetHeader() const
+    {
+        return *reinterpret_cast<const MeshFileHeader*>(mData);
+    }
+    
+    __attribute__((always_inline)) const void* GetVertexData() const { return mData + GetHeader().vertexOffset; }
+    __attribute__((always_inline)) size_t GetVertexDataSize() const { return (size_t)GetHeader().vertexBytes; }
+    __attribute__((always_inline)) const void* GetIndexData() const { return mData + GetHeader().indexOffset; }
+    __attribute__((always_inline)) size_t GetIndexDataSize() const { return (size_t)GetHeader().indexBytes; }
+    
+    // Returns the attribute description or nullptr if the mesh does not have it
+    const VertexAttributeDesc* FindAttribute(VertexAttribute attribute) const;
+    
+    Vector3 GetBoundsMin() const;
+    Vector3 GetBoundsMax() const;
+    
+    const std::string& GetErrorLog() const { return mErrorLog; }
+};
+
+} // namespace CookieEngine
+
+#endif
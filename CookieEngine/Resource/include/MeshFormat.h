@@ -0,0 +1,78 @@
+//
+//  MeshFormat.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_MeshFormat_h
+#define CookieEngine_MeshFormat_h
+
+#include <cstdint>
+
+namespace CookieEngine
+{
+
+// Binary mesh file (.cmesh) written by Tools/MeshConverter. The file is laid
+// out so it can be mapped and handed straight to the GPU:
+//
+//   MeshFileHeader
+//   vertex blob   interleaved vertices, starts on a kMeshBlobAlignment boundary
+//   index blob    uint16 or uint32 indices, starts on a kMeshBlobAlignment boundary
+//
+// All values are little endian.
+
+static const uint32_t kMeshMagic = 0x48534D43; // "CMSH"
+static const uint32_t kMeshVersion = 1;
+static const uint32_t kMeshBlobAlignment = 16;
+static const uint32_t kMaxVertexAttributes = 8;
+
+// Vertex attributes. The value doubles as the shader attribute location.
+enum class VertexAttribute : uint32_t
+{
+    Position = 0,
+    Normal = 1,
+    TexCoord = 2,
+    Color = 3,
+    Tangent = 4,
+    JointIndices = 5,   // 4 joint indices stored as floats
+    JointWeights = 6,   // 4 weights summing to 1
+};
+
+// One attribute inside an interleaved vertex. Components are always 32-bit floats.
+struct VertexAttributeDesc
+{
+    VertexAttribute attribute;
+    uint32_t components;
+    uint32_t offset;
+    uint32_t reserved;
+};
+
+struct MeshFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    
+    uint32_t vertexStride;
+    uint32_t indexSize;         // 2 or 4 bytes per index
+    uint32_t attributeCount;
+    uint32_t reserved;
+    
+    uint64_t vertexOffset;      // from the start of the file
+    uint64_t vertexBytes;
+    uint64_t indexOffset;
+    uint64_t indexBytes;
+    
+    float boundsMin[4];
+    float boundsMax[4];
+    
+    VertexAttributeDesc attributes[kMaxVertexAttributes];
+};
+
+static_assert(sizeof(MeshFileHeader) % kMeshBlobAlignment == 0, "Mesh header must keep blobs aligned");
+
+} // namespace CookieEngine
+
+#endif
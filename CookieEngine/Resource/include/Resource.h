@@ -0,0 +1,172 @@
+//
+//  Resource.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Resource_h
+#define CookieEngine_Resource_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CookieEngine
+{
+
+class ResourceManager;
+
+// Order in which queued loads are picked up by the I/O threads
+enum class LoadPriority : uint32_t
+{
+    Low,
+    Normal,
+    High,
+    Critical,
+};
+
+enum class ResourceState : uint32_t
+{
+    Queued,     // waiting for an I/O thread
+    Loading,    // being read into staging memory
+    Uploading,  // waiting for, or in the middle of, its GPU upload
+    Ready,
+    Failed,
+    Cancelled,  // every handle was dropped before the load started
+};
+
+// Base class of everything the ResourceManager streams in. A resource is
+// read into staging memory on an I/O thread, processed there, then uploaded
+// on the render thread in slices that fit the per-frame upload budget.
+class Resource
+{
+private:
+    friend class ResourceManager;
+    
+    std::string mPath;
+    std::atomic<uint32_t> mRefCount;
+    std::atomic<uint32_t> mPendingCount;    // references held by the manager's queues
+    std::atomic<ResourceState> mState;
+    LoadPriority mPriority;
+    void* mStaging;
+    size_t mStagingSize;
+    
+protected:
+    // Called on an I/O thread once the file is in staging memory.
+    // Return false to fail the load.
+    virtual bool Process(const void* data, size_t size);
+    
+    // Called on the render thread until done is set. Uploads at most budget
+    // bytes of data and returns how many bytes were uploaded.
+    virtual size_t Upload(const void* data, size_t size, size_t budget, bool& done);
+    
+    // Return true to keep the staging memory around after the upload
+    virtual bool KeepsStagingData() const;
+    
+    // Staging memory, only valid while loading or if KeepsStagingData
+    __attribute__((always_inline)) const void* GetStagingData() const { return mStaging; }
+    __attribute__((always_inline)) size_t GetStagingSize() const { return mStagingSize; }
+    
+public:
+    Resource();
+    virtual ~Resource();
+    
+    Resource(const Resource&) = delete;
+    Resource& operator=(const Resource&) = delete;
+    
+    __attribute__((always_inline)) void AddRef() { mRefCount.fetch_add(1, std::memory_order_relaxed); }
+    __attribute__((always_inline)) void Release() { mRefCount.fetch_sub(1, std::memory_order_acq_rel); }
+    __attribute__((always_inline)) uint32_t GetRefCount() const { return mRefCount.load(std::memory_order_acquire); }
+    
+    __attribute__((always_inline)) ResourceState GetState() const { return mState.load(std::memory_order_acquire); }
+    __attribute__((always_inline)) bool IsReady() const { return GetState() == ResourceState::Ready; }
+    __attribute__((always_inline)) bool IsFailed() const { return GetState() == ResourceState::Failed; }
+    
+    const std::string& GetPath() const { return mPath; }
+};
+
+// Ref-counted handle to a resource that becomes ready some time after it was requested
+template<typename T>
+class ResourceHandle
+{
+private:
+    T* mResource;
+    
+public:
+    ResourceHandle() : mResource(nullptr) {}
+    
+    explicit ResourceHandle(T* resource) : mResource(resource)
+    {
+        if(mResource)
+        {
+            mResource->AddRef();
+        }
+    }
+    
+    ResourceHandle(const ResourceHandle& rhs) : mResource(rhs.mResource)
+    {
+        if(mResource)
+        {
+            mResource->AddRef();
+        }
+    }
+    
+    ResourceHandle(ResourceHandle&& rhs) : mResource(rhs.mResource)
+    {
+        rhs.mResource = nullptr;
+    }
+    
+    ~ResourceHandle()
+    {
+        Reset();
+    }
+    
+    ResourceHandle& operator=(ResourceHandle rhs)
+    {
+        T* temp = mResource;
+        mResource = rhs.mResource;
+        rhs.mResource = temp;
+        return *this;
+    }
+    
+    void Reset()
+    {
+        if(mResource)
+        {
+            mResource->Release();
+            mResource = nullptr;
+        }
+    }
+    
+    __attribute__((always_inline)) bool IsValid() const { return mResource != nullptr; }
+    __attribute__((always_inline)) bool IsReady() const { return mResource && mResource->IsReady(); }
+    __attribute__((always_inline)) bool IsFailed() const { return !mResource || mResource->IsFailed(); }
+    
+    // Returns the resource once it is ready, nullptr before that
+    __attribute__((always_inline)) T* Get() const { return IsReady() ? mResource : nullptr; }
+    
+    __attribute__((always_inline)) T* operator->() const { return mResource; }
+};
+
+// Raw file contents kept in memory, e.g. shader sources
+class BlobResource : public Resource
+{
+protected:
+    bool KeepsStagingData() const override { return true; }
+    
+public:
+    __attribute__((always_inline)) const void* GetData() const { return GetStagingData(); }
+    __attribute__((always_inline)) size_t GetSize() const { return GetStagingSize(); }
+    
+    // Contents as a string, handy for ShaderProgram::attachShaderFromMemory
+    std::string GetString() const
+    {
+        return std::string(static_cast<const char*>(GetStagingData()), GetStagingSize());
+    }
+};
+
+} // namespace CookieEngine
+
+#endif
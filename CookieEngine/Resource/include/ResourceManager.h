@@ -0,0 +1,132 @@
+//
+//  ResourceManager.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ResourceManager_h
+#define CookieEngine_ResourceManager_h
+
+#include "Resource.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Streaming counters, read them with GetStats
+struct ResourceStats
+{
+    uint32_t queued;                // waiting for an I/O thread
+    uint32_t uploading;             // loaded, waiting for GPU upload
+    uint32_t resident;              // ready resources in the cache
+    uint64_t loadsCompleted;
+    uint64_t loadsFailed;
+    uint64_t bytesRead;
+    uint64_t bytesUploadedLastFrame;
+    double readSeconds;             // total time the I/O threads spent reading
+};
+
+// Loads resources asynchronously. Files are read on a pool of I/O threads in
+// priority order, processed there, and uploaded from Update on the render
+// thread without exceeding the per-frame upload budget. Requests for the same
+// path share one resource.
+class ResourceManager
+{
+private:
+    struct QueueEntry
+    {
+        LoadPriority priority;
+        uint64_t sequence;
+        Resource* resource;
+        
+        bool operator<(const QueueEntry& rhs) const
+        {
+            // Highest priority first, FIFO within a priority
+            if(priority != rhs.priority)
+            {
+                return priority < rhs.priority;
+            }
+            return sequence > rhs.sequence;
+        }
+    };
+    
+    std::vector<std::thread> mIoThreads;
+    
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCondition;
+    std::condition_variable mIdleCondition;
+    std::priority_queue<QueueEntry> mLoadQueue;
+    uint64_t mNextSequence;
+    uint32_t mLoadingCount;
+    bool mQuit;
+    
+    std::mutex mCacheMutex;
+    std::unordered_map<std::string, Resource*> mCache;
+    
+    std::mutex mUploadMutex;
+    std::deque<Resource*> mUploadQueue;
+    
+    size_t mUploadBudget;
+    
+    mutable std::mutex mStatsMutex;
+    ResourceStats mStats;
+    
+    void IoThreadMain();
+    void Enqueue(Resource* resource, LoadPriority priority);
+    void FreeStaging(Resource* resource);
+    
+    // Returns the cached resource at path or registers created, under mCacheMutex
+    Resource* FindOrInsert(const std::string& path, Resource* (*create)(), LoadPriority priority);
+    
+    template<typename T>
+    static Resource* Create() { return new T(); }
+    
+public:
+    // ioThreads readers, uploadBudget bytes of GPU uploads per Update
+    explicit ResourceManager(uint32_t ioThreads = 2, size_t uploadBudget = 4 * 1024 * 1024);
+    
+    // Stops the I/O threads and destroys all resources, MUST run on the render thread
+    ~ResourceManager();
+    
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+    
+    // Requests path. Returns at once with a handle that becomes ready later.
+    // Requesting a queued resource again with a higher priority bumps it.
+    template<typename T>
+    ResourceHandle<T> Load(const std::string& path, LoadPriority priority = LoadPriority::Normal)
+    {
+        Resource* resource = FindOrInsert(path, &Create<T>, priority);
+        T* typed = dynamic_cast<T*>(resource);
+        ResourceHandle<T> handle(typed);
+        
+        // FindOrInsert took a reference so the resource survives until the handle holds one
+        resource->Release();
+        return handle;
+    }
+    
+    // Runs GPU uploads within the budget and frees resources nobody references.
+    // Call once per frame on the render (GL) thread.
+    void Update();
+    
+    // Blocks until nothing is queued or loading, then uploads everything
+    // regardless of the budget. For loading screens.
+    void Flush();
+    
+    __attribute__((always_inline)) void SetUploadBudget(size_t bytes) { mUploadBudget = bytes; }
+    __attribute__((always_inline)) size_t GetUploadBudget() const { return mUploadBudget; }
+    
+    ResourceStats GetStats() const;
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,232 @@
+//
+//  FileReader.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "FileReader.h"
+#include "Allocator.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if COOKIE_USE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace CookieEngine
+{
+
+// Staging memory alignment, a cache line and a multiple of kMeshBlobAlignment so blobs stay aligned
+static const size_t kStagingAlignment = 64;
+
+static const size_t kReadChunkSize = 1024 * 1024;
+
+#if COOKIE_USE_IO_URING
+static const unsigned kRingDepth = 8;
+#endif
+
+FileReader::FileReader() : mRing(nullptr)
+{
+#if COOKIE_USE_IO_URING
+    io_uring* ring = new io_uring;
+    if(io_uring_queue_init(kRingDepth, ring, 0) == 0)
+    {
+        mRing = ring;
+    }
+    else
+    {
+        // Kernel without io_uring (or it is blocked), fall back to pread
+        delete ring;
+    }
+#endif
+}
+
+FileReader::~FileReader()
+{
+#if COOKIE_USE_IO_URING
+    if(mRing)
+    {
+        io_uring* ring = static_cast<io_uring*>(mRing);
+        io_uring_queue_exit(ring);
+        delete ring;
+    }
+#endif
+}
+
+bool FileReader::Read(const std::string& path, void*& data, size_t& size, std::string& error)
+{
+    data = nullptr;
+    size = 0;
+    
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        error = "Failed to open file: " + path;
+        return false;
+    }
+    
+    struct stat info;
+    if(fstat(fd, &info) != 0)
+    {
+        close(fd);
+        error = "Failed to stat file: " + path;
+        return false;
+    }
+    
+    size_t fileSize = (size_t)info.st_size;
+    unsigned char* buffer = static_cast<unsigned char*>(AlignedMalloc(fileSize ? fileSize : 1, kStagingAlignment));
+    if(!buffer)
+    {
+        close(fd);
+        error = "Out of staging memory for: " + path;
+        return false;
+    }
+    
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    
+    bool ok = mRing ? ReadWithIoUring(fd, buffer, fileSize) : ReadWithPread(fd, buffer, fileSize, 0);
+    close(fd);
+    
+    if(!ok)
+    {
+        AlignedFree(buffer);
+        error = "Failed to read file: " + path;
+        return false;
+    }
+    
+    data = buffer;
+    size = fileSize;
+    return true;
+}
+
+bool FileReader::ReadWithPread(int fd, unsigned char* data, size_t size, size_t fileOffset)
+{
+    size_t offset = 0;
+    while(offset < size)
+    {
+        size_t length = size - offset < kReadChunkSize ? size - offset : kReadChunkSize;
+        ssize_t result = pread(fd, data + offset, length, (off_t)(fileOffset + offset));
+        if(result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(result <= 0)
+        {
+            return false;
+        }
+        offset += (size_t)result;
+    }
+    return true;
+}
+
+bool FileReader::ReadWithIoUring(int fd, unsigned char* data, size_t size)
+{
+#if COOKIE_USE_IO_URING
+    io_uring* ring = static_cast<io_uring*>(mRing);
+    
+    size_t nextOffset = 0;
+    unsigned prepared = 0;      // queued in the ring, not handed to the kernel yet
+    unsigned submitted = 0;     // handed to the kernel, completion not seen yet
+    bool ok = true;
+    
+    // Keep up to kRingDepth chunk reads in flight until the file is in. Short
+    // reads are rare on regular files, their tail is finished with pread.
+    while(ok && (nextOffset < size || prepared + submitted > 0))
+    {
+        while(nextOffset < size && prepared + submitted < kRingDepth)
+        {
+            io_uring_sqe* sqe = io_uring_get_sqe(ring);
+            if(!sqe)
+            {
+                break;
+            }
+            
+            size_t length = size - nextOffset < kReadChunkSize ? size - nextOffset : kReadChunkSize;
+            io_uring_prep_read(sqe, fd, data + nextOffset, (unsigned)length, (__u64)nextOffset);
+            io_uring_sqe_set_data(sqe, (void*)(uintptr_t)nextOffset);
+            nextOffset += length;
+            prepared++;
+        }
+        
+        // The kernel may take fewer than were queued, the rest go with the next submit
+        int count = io_uring_submit(ring);
+        if(count < 0)
+        {
+            ok = false;
+            break;
+        }
+        prepared -= (unsigned)count;
+        submitted += (unsigned)count;
+        if(submitted == 0)
+        {
+            continue;
+        }
+        
+        // Interrupted by a signal, nothing completed, wait again
+        io_uring_cqe* cqe;
+        int waited = io_uring_wait_cqe(ring, &cqe);
+        if(waited == -EINTR)
+        {
+            continue;
+        }
+        if(waited < 0)
+        {
+            ok = false;
+            break;
+        }
+        
+        size_t offset = (size_t)(uintptr_t)io_uring_cqe_get_data(cqe);
+        size_t length = size - offset < kReadChunkSize ? size - offset : kReadChunkSize;
+        int result = cqe->res;
+        io_uring_cqe_seen(ring, cqe);
+        submitted--;
+        
+        if(result < 0)
+        {
+            ok = false;
+        }
+        else if((size_t)result < length)
+        {
+            ok = ReadWithPread(fd, data + offset + result, length - (size_t)result, offset + (size_t)result);
+        }
+    }
+    
+    // Never leave reads into a buffer that is about to be freed. Only submitted
+    // reads complete, waiting for the ones still queued would never return.
+    while(submitted > 0)
+    {
+        io_uring_cqe* cqe;
+        int waited = io_uring_wait_cqe(ring, &cqe);
+        if(waited == -EINTR)
+        {
+            continue;
+        }
+        if(waited < 0)
+        {
+            break;
+        }
+        io_uring_cqe_seen(ring, cqe);
+        submitted--;
+    }
+    
+    // Queued reads would go out with the next file's and write into this
+    // buffer after it is freed. Only dropping the ring takes them back, later
+    // files are read with pread.
+    if(prepared > 0)
+    {
+        io_uring_queue_exit(ring);
+        delete ring;
+        mRing = nullptr;
+    }
+    
+    return ok;
+#else
+    return ReadWithPread(fd, data, size, 0);
+#endif
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,173 @@
+//
+//  MeshFile.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "MeshFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CookieEngine
+{
+
+MeshFile::MeshFile() : mData(nullptr), mSize(0), mMapped(false), mErrorLog()
+{
+}
+
+MeshFile::~MeshFile()
+{
+    Close();
+}
+
+bool MeshFile::Open(const std::string& filename)
+{
+    Close();
+    
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        mErrorLog = "Failed to open file: " + filename;
+        return false;
+    }
+    
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(MeshFileHeader))
+    {
+        close(fd);
+        mErrorLog = "File too small to be a mesh: " + filename;
+        return false;
+    }
+    
+    void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        mErrorLog = "Failed to map file: " + filename;
+        return false;
+    }
+    
+    // The whole file is about to be uploaded, so start paging it in now
+    madvise(mapping, (size_t)info.st_size, MADV_WILLNEED);
+    
+    mData = static_cast<const uint8_t*>(mapping);
+    mSize = (size_t)info.st_size;
+    mMapped = true;
+    
+    if(!Validate())
+    {
+        mErrorLog += ": " + filename;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MeshFile::OpenFromMemory(const void* data, size_t size)
+{
+    Close();
+    
+    if(size < sizeof(MeshFileHeader))
+    {
+        mErrorLog = "Buffer too small to be a mesh";
+        return false;
+    }
+    
+    mData = static_cast<const uint8_t*>(data);
+    mSize = size;
+    mMapped = false;
+    
+    if(!Validate())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshFile::Close()
+{
+    if(mData && mMapped)
+    {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+}
+
+bool MeshFile::Validate()
+{
+    const MeshFileHeader& header = GetHeader();
+    
+    if(header.magic != kMeshMagic)
+    {
+        mErrorLog = "Not a mesh file";
+        return false;
+    }
+    if(header.version != kMeshVersion)
+    {
+        mErrorLog = "Unsupported mesh version";
+        return false;
+    }
+    if(header.attributeCount > kMaxVertexAttributes || (header.indexSize != 2 && header.indexSize != 4))
+    {
+        mErrorLog = "Corrupt mesh header";
+        return false;
+    }
+    if(header.vertexOffset % kMeshBlobAlignment != 0 || header.indexOffset % kMeshBlobAlignment != 0 ||
+       header.vertexOffset > mSize || header.vertexBytes > mSize - header.vertexOffset ||
+       header.indexOffset > mSize || header.indexBytes > mSize - header.indexOffset ||
+       header.vertexBytes != (uint64_t)header.vertexCount * header.vertexStride ||
+       header.indexBytes != (uint64_t)header.indexCount * header.indexSize)
+    {
+        mErrorLog = "Mesh blobs out of range";
+        return false;
+    }
+    
+    // Attributes go to glVertexAttribPointer as they are, each has to be a valid
+    // location and lie inside one vertex
+    for(uint32_t i = 0; i < header.attributeCount; i++)
+    {
+        const VertexAttributeDesc& attribute = header.attributes[i];
+        if((uint32_t)attribute.attribute >= kMaxVertexAttributes || attribute.components == 0 || attribute.components > 4 ||
+           attribute.offset > header.vertexStride ||
+           attribute.components * sizeof(float) > header.vertexStride - attribute.offset)
+        {
+            mErrorLog = "Vertex attribute out of range";
+            return false;
+        }
+    }
+    
+    mErrorLog.clear();
+    return true;
+}
+
+const VertexAttributeDesc* MeshFile::FindAttribute(VertexAttribute attribute) const
+{
+    const MeshFileHeader& header = GetHeader();
+    for(uint32_t i = 0; i < header.attributeCount; i++)
+    {
+        if(header.attributes[i].attribute == attribute)
+        {
+            return &header.attributes[i];
+        }
+    }
+    return nullptr;
+}
+
+Vector3 MeshFile::GetBoundsMin() const
+{
+    return _mm_loadu_ps(GetHeader().boundsMin);
+}
+
+Vector3 MeshFile::GetBoundsMax() const
+{
+    return _mm_loadu_ps(GetHeader().boundsMax);
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,38 @@
+//
+//  Resource.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Resource.h"
+
+namespace CookieEngine
+{
+
+Resource::Resource() : mPath(), mRefCount(0), mPendingCount(0), mState(ResourceState::Queued),
+                       mPriority(LoadPriority::Normal), mStaging(nullptr), mStagingSize(0)
+{
+}
+
+Resource::~Resource()
+{
+}
+
+bool Resource::Process(const void*, size_t)
+{
+    return true;
+}
+
+size_t Resource::Upload(const void*, size_t, size_t, bool& done)
+{
+    done = true;
+    return 0;
+}
+
+bool Resource::KeepsStagingData() const
+{
+    return false;
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,335 @@
+//
+//  ResourceManager.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ResourceManager.h"
+#include "Allocator.h"
+#include "FileReader.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace CookieEngine
+{
+
+ResourceManager::ResourceManager(uint32_t ioThreads, size_t uploadBudget)
+    : mIoThreads(), mNextSequence(0), mLoadingCount(0), mQuit(false), mUploadBudget(uploadBudget)
+{
+    memset(&mStats, 0, sizeof(mStats));
+    
+    if(ioThreads == 0)
+    {
+        ioThreads = 1;
+    }
+    for(uint32_t i = 0; i < ioThreads; i++)
+    {
+        mIoThreads.push_back(std::thread(&ResourceManager::IoThreadMain, this));
+    }
+}
+
+ResourceManager::~ResourceManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        mQuit = true;
+    }
+    mQueueCondition.notify_all();
+    
+    for(size_t i = 0; i < mIoThreads.size(); i++)
+    {
+        mIoThreads[i].join();
+    }
+    
+    for(std::unordered_map<std::string, Resource*>::iterator it = mCache.begin(); it != mCache.end(); ++it)
+    {
+        FreeStaging(it->second);
+        delete it->second;
+    }
+}
+
+void ResourceManager::Enqueue(Resource* resource, LoadPriority priority)
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        resource->mPendingCount++;
+        
+        QueueEntry entry = { priority, mNextSequence++, resource };
+        mLoadQueue.push(entry);
+    }
+    mQueueCondition.notify_one();
+}
+
+Resource* ResourceManager::FindOrInsert(const std::string& path, Resource* (*create)(), LoadPriority priority)
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    
+    std::unordered_map<std::string, Resource*>::iterator it = mCache.find(path);
+    if(it != mCache.end())
+    {
+        Resource* resource = it->second;
+        resource->AddRef();
+        
+        ResourceState state = resource->GetState();
+        if(state == ResourceState::Cancelled)
+        {
+            resource->mState = ResourceState::Queued;
+            resource->mPriority = priority;
+            Enqueue(resource, priority);
+        }
+        else if(state == ResourceState::Queued && priority > resource->mPriority)
+        {
+            // The old entry is skipped once the resource has left the Queued state
+            resource->mPriority = priority;
+            Enqueue(resource, priority);
+        }
+        return resource;
+    }
+    
+    Resource* resource = create();
+    resource->mPath = path;
+    resource->mPriority = priority;
+    resource->mState = ResourceState::Queued;
+    resource->AddRef();
+    mCache[path] = resource;
+    
+    Enqueue(resource, priority);
+    return resource;
+}
+
+void ResourceManager::FreeStaging(Resource* resource)
+{
+    AlignedFree(resource->mStaging);
+    resource->mStaging = nullptr;
+    resource->mStagingSize = 0;
+}
+
+void ResourceManager::IoThreadMain()
+{
+    FileReader reader;
+    
+    for(;;)
+    {
+        Resource* resource;
+        {
+            std::unique_lock<std::mutex> lock(mQueueMutex);
+            mQueueCondition.wait(lock, [this] { return mQuit || !mLoadQueue.empty(); });
+            if(mQuit)
+            {
+                return;
+            }
+            
+            resource = mLoadQueue.top().resource;
+            mLoadQueue.pop();
+            
+            // Counted as loading until it is known to be stale, so Flush keeps waiting
+            mLoadingCount++;
+        }
+        
+        // FindOrInsert adds references and requeues cancelled resources under
+        // the cache lock, deciding here under the same lock keeps it from
+        // reviving a resource this thread is about to cancel
+        bool skip = false;
+        {
+            std::lock_guard<std::mutex> lock(mCacheMutex);
+            if(resource->GetState() != ResourceState::Queued)
+            {
+                // Stale entry left behind by a priority bump
+                skip = true;
+            }
+            else if(resource->GetRefCount() == 0)
+            {
+                resource->mState = ResourceState::Cancelled;
+                skip = true;
+            }
+            else
+            {
+                resource->mState = ResourceState::Loading;
+            }
+        }
+        
+        if(skip)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mQueueMutex);
+                resource->mPendingCount--;
+                mLoadingCount--;
+            }
+            mIdleCondition.notify_all();
+            continue;
+        }
+        
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        
+        void* data = nullptr;
+        size_t size = 0;
+        std::string error;
+        bool ok = reader.Read(resource->GetPath(), data, size, error);
+        
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        
+        if(ok)
+        {
+            resource->mStaging = data;
+            resource->mStagingSize = size;
+            ok = resource->Process(data, size);
+            if(!ok)
+            {
+                error = "Failed to process resource: " + resource->GetPath();
+                FreeStaging(resource);
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mStatsMutex);
+            mStats.bytesRead += size;
+            mStats.readSeconds += seconds;
+            if(!ok)
+            {
+                mStats.loadsFailed++;
+            }
+        }
+        
+        if(ok)
+        {
+            resource->mState = ResourceState::Uploading;
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            mUploadQueue.push_back(resource);
+        }
+        else
+        {
+            std::cerr << error << "\n";
+            resource->mState = ResourceState::Failed;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mQueueMutex);
+            resource->mPendingCount--;
+            mLoadingCount--;
+        }
+        mIdleCondition.notify_all();
+    }
+}
+
+void ResourceManager::Update()
+{
+    size_t remaining = mUploadBudget;
+    uint64_t uploaded = 0;
+    uint64_t completed = 0;
+    
+    while(remaining > 0)
+    {
+        Resource* resource;
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            if(mUploadQueue.empty())
+            {
+                break;
+            }
+            resource = mUploadQueue.front();
+        }
+        
+        bool done = false;
+        size_t used = resource->Upload(resource->mStaging, resource->mStagingSize, remaining, done);
+        used = used < remaining ? used : remaining;
+        remaining -= used;
+        uploaded += used;
+        
+        if(!done)
+        {
+            // Out of budget for this frame, carry on next Update
+            break;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            mUploadQueue.pop_front();
+        }
+        
+        if(!resource->KeepsStagingData())
+        {
+            FreeStaging(resource);
+        }
+        resource->mState = ResourceState::Ready;
+        completed++;
+    }
+    
+    // Destroy resources nobody holds anymore. Only finished resources are
+    // touched, so no I/O thread can be working on them.
+    uint32_t resident = 0;
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        for(std::unordered_map<std::string, Resource*>::iterator it = mCache.begin(); it != mCache.end();)
+        {
+            Resource* resource = it->second;
+            ResourceState state = resource->GetState();
+            bool finished = state == ResourceState::Ready || state == ResourceState::Failed || state == ResourceState::Cancelled;
+            
+            if(finished && resource->GetRefCount() == 0 && resource->mPendingCount.load() == 0)
+            {
+                FreeStaging(resource);
+                delete resource;
+                it = mCache.erase(it);
+                continue;
+            }
+            
+            resident += state == ResourceState::Ready ? 1 : 0;
+            ++it;
+        }
+    }
+    
+    uint32_t queued;
+    uint32_t uploading;
+    {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        queued = (uint32_t)mLoadQueue.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mUploadMutex);
+        uploading = (uint32_t)mUploadQueue.size();
+    }
+    
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.queued = queued;
+    mStats.uploading = uploading;
+    mStats.resident = resident;
+    mStats.loadsCompleted += completed;
+    mStats.bytesUploadedLastFrame = uploaded;
+}
+
+void ResourceManager::Flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mIdleCondition.wait(lock, [this] { return mLoadQueue.empty() && mLoadingCount == 0; });
+    }
+    
+    size_t budget = mUploadBudget;
+    mUploadBudget = std::numeric_limits<size_t>::max();
+    
+    for(;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            if(mUploadQueue.empty())
+            {
+                break;
+            }
+        }
+        Update();
+    }
+    
+    mUploadBudget = budget;
+}
+
+ResourceStats ResourceManager::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    return mStats;
+}
+
+} // namespace CookieEngine
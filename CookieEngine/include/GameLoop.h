@@ -0,0 +1,122 @@
+//
+//  GameLoop.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_GameLoop_h
+#define CookieEngine_GameLoop_h
+
+#include "AlignedAllocator.h"
+#include "CookieMath.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace CookieEngine
+{
+
+typedef std::chrono::steady_clock GameClock;
+
+// Transforms produced by one simulation step
+struct TransformSnapshot
+{
+    uint64_t step;
+    double simTime;
+    GameClock::time_point publishTime;
+    AlignedVector<Matrix4> transforms;
+};
+
+// Timing of the simulation and render threads, all durations in seconds
+struct GameLoopStats
+{
+    uint64_t steps;
+    uint64_t droppedSteps;          // steps skipped because the simulation fell too far behind
+    double lastStepCost;
+    double averageStepCost;
+    double maxStepCost;
+    double lastRenderCost;
+    double averageRenderCost;
+    double lastSnapshotLatency;     // age of the newest snapshot when the render thread picked it up
+    double averageSnapshotLatency;
+};
+
+// Runs the simulation at a fixed timestep on its own thread. Each step writes
+// a TransformSnapshot; the render thread interpolates between the last two
+// snapshots, so rendering stays smooth at any frame rate and simulation cost
+// no longer adds to frame time.
+class GameLoop
+{
+public:
+    // Fills snapshot.transforms for the step that advances the world by dt.
+    // Runs on the simulation thread.
+    typedef std::function<void(double dt, TransformSnapshot& snapshot)> SimulateFunction;
+    
+private:
+    // Two published states plus the one being written, and two more the
+    // render thread may still be interpolating between. That is the fewest
+    // slots with which neither thread ever waits for the other.
+    static const int kSlotCount = 5;
+    
+    TransformSnapshot mSlots[kSlotCount];
+    int mLatest;
+    int mPrevious;
+    int mReadSlots[2];
+    std::mutex mSlotMutex;
+    
+    double mStepSeconds;
+    uint32_t mMaxCatchUpSteps;
+    SimulateFunction mSimulate;
+    std::thread mThread;
+    std::atomic<bool> mRunning;
+    
+    mutable std::mutex mStatsMutex;
+    GameLoopStats mStats;
+    GameClock::time_point mRenderStart;
+    
+    void SimulationMain();
+    int AcquireWriteSlot();
+    void Publish(int slot);
+    
+public:
+    // transformCount transforms per snapshot, simulation runs every stepSeconds
+    explicit GameLoop(size_t transformCount, double stepSeconds = 1.0 / 60.0);
+    
+    // Stops the simulation thread
+    ~GameLoop();
+    
+    GameLoop(const GameLoop&) = delete;
+    GameLoop& operator=(const GameLoop&) = delete;
+    
+    // Starts the simulation thread
+    void Start(const SimulateFunction& simulate);
+    
+    // Stops and joins the simulation thread
+    void Stop();
+    
+    __attribute__((always_inline)) bool IsRunning() const { return mRunning.load(); }
+    
+    // Render thread: writes the transforms of the moment between the last two
+    // snapshots that corresponds to now into out. Returns false until the
+    // simulation has produced two snapshots.
+    bool Interpolate(AlignedVector<Matrix4>& out);
+    
+    // Render thread: bracket the frame with these to measure render cost
+    void BeginRender();
+    void EndRender();
+    
+    // Largest number of steps run back to back to catch up before time is dropped
+    __attribute__((always_inline)) void SetMaxCatchUpSteps(uint32_t steps) { mMaxCatchUpSteps = steps; }
+    
+    __attribute__((always_inline)) double GetStepSeconds() const { return mStepSeconds; }
+    
+    GameLoopStats GetStats() const;
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,76 @@
+//
+//  JobSystem.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_JobSystem_h
+#define CookieEngine_JobSystem_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CookieEngine
+{
+
+// Fixed pool of worker threads that split data parallel loops into ranges.
+// The thread calling ParallelFor takes part in the work, so a JobSystem with
+// zero workers simply runs everything inline.
+class JobSystem
+{
+public:
+    typedef std::function<void(uint32_t begin, uint32_t end)> RangeFunction;
+    
+    // Spawns workerCount threads, 0 picks one less than the hardware thread count
+    explicit JobSystem(uint32_t workerCount = 0);
+    
+    // Joins all worker threads
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // Splits [0, count) into ranges of at most grainSize elements and runs
+    // func(begin, end) for each of them. Blocks until every range is done.
+    // A ParallelFor called from inside func runs its ranges on the calling thread.
+    void ParallelFor(uint32_t count, uint32_t grainSize, const RangeFunction& func);
+    
+    // Number of threads that run jobs, including the calling thread
+    uint32_t GetThreadCount() const { return (uint32_t)mWorkers.size() + 1; }
+    
+    // Index of the current thread in [0, GetThreadCount()), the calling thread is 0.
+    // Useful for picking per-thread buffers inside a ParallelFor body.
+    static uint32_t GetThreadIndex();
+    
+private:
+    void WorkerMain(uint32_t threadIndex);
+    void RunRanges(const RangeFunction* func, uint32_t count, uint32_t grainSize);
+    
+    std::vector<std::thread> mWorkers;
+    
+    std::mutex mSubmitMutex;
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+    
+    // Current batch, guarded by mMutex
+    const RangeFunction* mFunc;
+    uint32_t mCount;
+    uint32_t mGrainSize;
+    uint64_t mGeneration;
+    uint32_t mActiveWorkers;
+    bool mQuit;
+    
+    std::atomic<uint32_t> mNextIndex;
+    std::atomic<uint32_t> mRemainingRanges;
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,79 @@
+//
+//  Mesh.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_Mesh_h
+#define CookieEngine_Mesh_h
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "MeshFormat.h"
+#include "Vector3.h"
+
+namespace CookieEngine
+{
+
+class MeshFile;
+
+// Vertex and index buffers of a mesh on the GPU
+class Mesh
+{
+private:
+    GLuint mVertexArray;
+    GLuint mVertexBuffer;
+    GLuint mIndexBuffer;
+    uint32_t mIndexCount;
+    GLenum mIndexType;
+    uint32_t mVertexStride;
+    uint32_t mAttributeCount;
+    VertexAttributeDesc mAttributes[kMaxVertexAttributes];
+    Vector3 mBoundsMin;
+    Vector3 mBoundsMax;
+    
+public:
+    // Constructor
+    Mesh();
+    
+    // Destructor
+    virtual ~Mesh();
+    
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    
+    // Uploads the blobs of file as they are, no conversion happens on the CPU
+    bool Upload(const MeshFile& file);
+    
+    // Creates the buffers without data, fill them later with UploadVertices/UploadIndices
+    void Allocate(const MeshFileHeader& header);
+    
+    // Uploads size bytes of vertex data starting at byte offset
+    void UploadVertices(const void* data, size_t offset, size_t size);
+    
+    // Uploads size bytes of index data starting at byte offset
+    void UploadIndices(const void* data, size_t offset, size_t size);
+    
+    // Frees the GPU buffers and the vertex array
+    void Release();
+    
+    // Binds the vertex array, attribute locations are the VertexAttribute values
+    void Bind() const;
+    void Unbind() const;
+    
+    // Draws the whole mesh, MUST be bound
+    void Draw() const;
+    
+    __attribute__((always_inline)) const Vector3& GetBoundsMin() const { return mBoundsMin; }
+    __attribute__((always_inline)) const Vector3& GetBoundsMax() const { return mBoundsMax; }
+    __attribute__((always_inline)) uint32_t GetIndexCount() const { return mIndexCount; }
+    __attribute__((always_inline)) GLuint GetVertexArray() const { return mVertexArray; }
+    __attribute__((always_inline)) GLuint GetVertexBuffer() const { return mVertexBuffer; }
+    __attribute__((always_inline)) GLuint GetIndexBuffer() const { return mIndexBuffer; }
+} __attribute__ ((aligned (16)));
+
+} // namespace CookieEngine
+
+#endif
@@ -0,0 +1,41 @@
+//
+//  MeshResource.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_MeshResource_h
+#define CookieEngine_MeshResource_h
+
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "Resource.h"
+
+namespace CookieEngine
+{
+
+// Streamed .cmesh. The header is validated on the I/O thread and the blobs
+// are uploaded in budget sized slices with glBufferSubData, so a large mesh
+// can take several frames to become ready.
+class MeshResource : public Resource
+{
+private:
+    MeshFile mFile;
+    Mesh mMesh;
+    size_t mUploadOffset;
+    bool mAllocated;
+    
+protected:
+    bool Process(const void* data, size_t size) override;
+    size_t Upload(const void* data, size_t size, size_t budget, bool& done) override;
+    
+public:
+    MeshResource();
+    
+    __attribute__((always_inline)) const Mesh& GetMesh() const { return mMesh; }
+};
+
+} // namespace CookieEngine
+
+#endif
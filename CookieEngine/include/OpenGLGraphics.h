@@ -0,0 +1,22 @@
+//
+//  OpenGLGraphics.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_OpenGLGraphics_h
+#define CookieEngine_OpenGLGraphics_h
+
+#include "GraphicsFunctions.h"
+
+namespace CookieEngine
+{
+
+// Graphics table that replays render commands through the current OpenGL
+// context. GLEW MUST be initialized before the table is used.
+GraphicsFunctions GetOpenGLFunctions();
+
+} // namespace CookieEngine
+
+#endif
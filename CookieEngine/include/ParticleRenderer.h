@@ -0,0 +1,62 @@
+//
+//  ParticleRenderer.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_ParticleRenderer_h
+#define CookieEngine_ParticleRenderer_h
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "ParticleSystem.h"
+
+namespace CookieEngine
+{
+
+class JobSystem;
+class ShaderProgram;
+
+// Attribute locations used by particle.vert, bind them before linking
+static const GLuint kParticlePositionLocation = 0;
+static const GLuint kParticleColorLocation = 1;
+
+// Streams the live particles of a ParticleSystem into a dynamic vertex buffer
+// every frame and draws them as point sprites
+class ParticleRenderer
+{
+private:
+    GLuint mVertexArray;
+    GLuint mVertexBuffer;
+    uint32_t mCapacity;
+    uint32_t mVertexCount;
+    
+public:
+    // Constructor
+    ParticleRenderer();
+    
+    // Destructor
+    virtual ~ParticleRenderer();
+    
+    ParticleRenderer(const ParticleRenderer&) = delete;
+    ParticleRenderer& operator=(const ParticleRenderer&) = delete;
+    
+    // Writes the particles of system into the vertex buffer. The buffer is
+    // orphaned first so the driver never stalls on last frame's draw.
+    void Stream(const ParticleSystem& system, JobSystem* jobs);
+    
+    // Draws the last streamed particles with program, which must use the
+    // particle.vert attribute layout
+    void Draw(ShaderProgram& program) const;
+    
+    // Frees the GPU buffer and the vertex array
+    void Release();
+    
+    __attribute__((always_inline)) uint32_t GetVertexCount() const { return mVertexCount; }
+};
+
+} // namespace CookieEngine
+
+#endif
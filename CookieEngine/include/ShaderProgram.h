@@ -14,6 +14,8 @@
 
 #include <string>
 
+#include "Matrix4.h"
+
 namespace CookieEngine
 {
     
@@ -47,6 +49,7 @@ public:
     bool isLinked();
     
     void bindAttributeLocation(GLuint location, const GLchar* name);
+    bool bindUniformBlock(const GLchar* name, GLuint binding);
     
     GLint getUniformLocation(const GLchar* name);
     GLint getAttributeLocation(const GLchar* name);
@@ -58,6 +61,7 @@ public:
     void setUniform(const GLchar* name, unsigned int x);
     void setUniform(const GLchar* name, int x);
     void setUniform(const GLchar* name, bool x);
+    void setUniform(const GLchar* name, const Matrix4& m);
     
     inline GLuint object() const { return mObject; }
     const std::string errorLog() const { return mErrorLog; }
@@ -0,0 +1,55 @@
+//
+//  SkinningPalette.h
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef CookieEngine_SkinningPalette_h
+#define CookieEngine_SkinningPalette_h
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "Matrix4.h"
+
+namespace CookieEngine
+{
+
+// Must match MAX_JOINTS in skinned.vert. 128 mat4 are 8 KB, half of the
+// smallest GL_MAX_UNIFORM_BLOCK_SIZE an implementation may report.
+static const uint32_t kMaxPaletteJoints = 128;
+
+// Uniform buffer holding a skinning palette for GPU skinning. The block is
+// declared row_major in the shader, so Matrix4 rows are uploaded as they are.
+class SkinningPalette
+{
+private:
+    GLuint mBuffer;
+    uint32_t mJointCount;
+    
+public:
+    // Constructor
+    SkinningPalette();
+    
+    // Destructor
+    virtual ~SkinningPalette();
+    
+    SkinningPalette(const SkinningPalette&) = delete;
+    SkinningPalette& operator=(const SkinningPalette&) = delete;
+    
+    // Uploads count palette matrices, at most kMaxPaletteJoints. Returns false if there are too many.
+    bool Upload(const Matrix4* palette, uint32_t count);
+    
+    // Binds the buffer to uniform block binding point, see ShaderProgram::bindUniformBlock
+    void Bind(GLuint binding) const;
+    
+    // Frees the GPU buffer
+    void Release();
+    
+    __attribute__((always_inline)) uint32_t GetJointCount() const { return mJointCount; }
+};
+
+} // namespace CookieEngine
+
+#endif
@@ -10,6 +10,9 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "CookieMath.h"
+#include "GameLoop.h"
+#include "OpenGLGraphics.h"
+#include "Render.h"
 #include "ShaderProgram.h"
 
 int main(int argc, const char * argv[]) {
@@ -23,6 +26,13 @@ int main(int argc, const char * argv[]) {
     
     glfwWindowHint(GLFW_SAMPLES, 4);    // 4x AA
     
+    // Core 3.3 context, the renderer draws through vertex arrays and never uses the fixed pipeline.
+    // Forward compatible is what macOS needs to hand out anything newer than 2.1.
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    
     window = glfwCreateWindow(1024, 768, "Cookie Engine", nullptr, nullptr);
     
     if(!window){
@@ -33,6 +43,8 @@ int main(int argc, const char * argv[]) {
     
     glfwMakeContextCurrent(window);
     
+    // Without it GLEW looks up entry points through the extension string, which core contexts do not have
+    glewExperimental = GL_TRUE;
     if(glewInit() != GLEW_OK){
         std::cout << "Failed to initialize GLEW\n";
         return -1;
@@ -47,11 +59,21 @@ int main(int argc, const char * argv[]) {
         +0.5f, -0.5f, 0.0f, 0.0f, 1.0f,
     };
     
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    
     GLuint vbo;
     glGenBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), 0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (const GLvoid*)(2*sizeof(float)));
+    glBindVertexArray(0);
+    
     CookieEngine::ShaderProgram shaderProgram;
     shaderProgram.attachShaderFromFile(CookieEngine::ShaderType::Vertex, "shaders/default.vert");
     shaderProgram.attachShaderFromFile(CookieEngine::ShaderType::Fragment, "shaders/default.frag");
@@ -59,32 +81,56 @@ int main(int argc, const char * argv[]) {
     shaderProgram.bindAttributeLocation(0, "vertPosition");
     shaderProgram.bindAttributeLocation(1, "vertColor");
     shaderProgram.link();
-    shaderProgram.use();
+    GLint modelLocation = shaderProgram.getUniformLocation("model");
+    
+    // Draws are recorded as commands and replayed here, the only thread with a GL context
+    CookieEngine::RenderQueue renderQueue;
+    CookieEngine::GraphicsFunctions gl = CookieEngine::GetOpenGLFunctions();
+    
+    // The simulation spins the triangle on its own thread at a fixed rate,
+    // rendering interpolates between its last two steps
+    CookieEngine::GameLoop gameLoop(1);
+    float angle = 0.0f;
+    gameLoop.Start([&angle](double dt, CookieEngine::TransformSnapshot& snapshot)
+    {
+        angle += (float)dt;
+        snapshot.transforms[0].CreateRotationZ(angle);
+    });
+    
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> transforms;
     
     do
     {
-        glClearColor(0.5f, 0.69f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        gameLoop.BeginRender();
+        
+        if(!gameLoop.Interpolate(transforms))
+        {
+            transforms.assign(1, CookieEngine::Matrix4::Identity);
+        }
         
         // DRAW STUFF HERE
         {
-            glEnableVertexAttribArray(0);
-            glEnableVertexAttribArray(1);
-            
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), 0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (const GLvoid*)(2*sizeof(float)));
-            
-            glDrawArrays(GL_TRIANGLES, 0, 3);
-            
-            glDisableVertexAttribArray(0);
-            glDisableVertexAttribArray(1);
+            CookieEngine::RenderCommandList& commands = renderQueue.AddList();
+            commands.Clear(CookieEngine::ClearColor, 0.5f, 0.69f, 1.0f, 1.0f);
+            commands.UseProgram(shaderProgram.object());
+            commands.SetUniform(modelLocation, transforms[0]);
+            commands.BindVertexArray(vao);
+            commands.Draw(CookieEngine::PrimitiveType::Triangles, 0, 3);
         }
+        renderQueue.Submit(gl);
+        
+        gameLoop.EndRender();
         
         // Swap buffers
         glfwSwapBuffers(window);
         glfwPollEvents();
     }while(!glfwWindowShouldClose(window));
     
+    gameLoop.Stop();
+    
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    
     glfwDestroyWindow(window);
     glfwTerminate();
     
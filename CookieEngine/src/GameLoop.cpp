@@ -0,0 +1,200 @@
+//
+//  GameLoop.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "GameLoop.h"
+
+#include <cstring>
+
+namespace CookieEngine
+{
+
+// Weight of the newest sample in the running averages
+static const double kAverageWeight = 0.05;
+
+static double Seconds(GameClock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static void Accumulate(double& average, double sample)
+{
+    average = average == 0.0 ? sample : average + (sample - average) * kAverageWeight;
+}
+
+GameLoop::GameLoop(size_t transformCount, double stepSeconds)
+    : mLatest(-1), mPrevious(-1), mStepSeconds(stepSeconds), mMaxCatchUpSteps(5), mSimulate(),
+      mThread(), mRunning(false), mRenderStart()
+{
+    mReadSlots[0] = -1;
+    mReadSlots[1] = -1;
+    memset(&mStats, 0, sizeof(mStats));
+    
+    for(int i = 0; i < kSlotCount; i++)
+    {
+        mSlots[i].step = 0;
+        mSlots[i].simTime = 0.0;
+        mSlots[i].transforms.resize(transformCount, Matrix4::Identity);
+    }
+}
+
+GameLoop::~GameLoop()
+{
+    Stop();
+}
+
+void GameLoop::Start(const SimulateFunction& simulate)
+{
+    Stop();
+    
+    mSimulate = simulate;
+    mLatest = -1;
+    mPrevious = -1;
+    mRunning = true;
+    mThread = std::thread(&GameLoop::SimulationMain, this);
+}
+
+void GameLoop::Stop()
+{
+    if(mThread.joinable())
+    {
+        mRunning = false;
+        mThread.join();
+    }
+}
+
+int GameLoop::AcquireWriteSlot()
+{
+    std::lock_guard<std::mutex> lock(mSlotMutex);
+    for(int i = 0; i < kSlotCount; i++)
+    {
+        if(i != mLatest && i != mPrevious && i != mReadSlots[0] && i != mReadSlots[1])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GameLoop::Publish(int slot)
+{
+    std::lock_guard<std::mutex> lock(mSlotMutex);
+    mSlots[slot].publishTime = GameClock::now();
+    mPrevious = mLatest;
+    mLatest = slot;
+}
+
+void GameLoop::SimulationMain()
+{
+    GameClock::duration step = std::chrono::duration_cast<GameClock::duration>(std::chrono::duration<double>(mStepSeconds));
+    GameClock::time_point nextStep = GameClock::now();
+    uint64_t stepIndex = 0;
+    
+    while(mRunning.load())
+    {
+        GameClock::time_point now = GameClock::now();
+        if(now < nextStep)
+        {
+            std::this_thread::sleep_until(nextStep);
+            continue;
+        }
+        
+        // After a long hitch drop the backlog instead of spiralling further behind
+        if(now - nextStep > step * mMaxCatchUpSteps)
+        {
+            uint64_t dropped = (uint64_t)((now - nextStep) / step);
+            nextStep += step * dropped;
+            
+            std::lock_guard<std::mutex> lock(mStatsMutex);
+            mStats.droppedSteps += dropped;
+        }
+        
+        int slot = AcquireWriteSlot();
+        TransformSnapshot& snapshot = mSlots[slot];
+        snapshot.step = stepIndex;
+        snapshot.simTime = stepIndex * mStepSeconds;
+        
+        GameClock::time_point start = GameClock::now();
+        mSimulate(mStepSeconds, snapshot);
+        double cost = Seconds(GameClock::now() - start);
+        
+        Publish(slot);
+        stepIndex++;
+        nextStep += step;
+        
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats.steps++;
+        mStats.lastStepCost = cost;
+        mStats.maxStepCost = cost > mStats.maxStepCost ? cost : mStats.maxStepCost;
+        Accumulate(mStats.averageStepCost, cost);
+    }
+}
+
+bool GameLoop::Interpolate(AlignedVector<Matrix4>& out)
+{
+    int previous;
+    int latest;
+    {
+        std::lock_guard<std::mutex> lock(mSlotMutex);
+        if(mPrevious < 0)
+        {
+            return false;
+        }
+        previous = mPrevious;
+        latest = mLatest;
+        mReadSlots[0] = previous;
+        mReadSlots[1] = latest;
+    }
+    
+    const TransformSnapshot& a = mSlots[previous];
+    const TransformSnapshot& b = mSlots[latest];
+    
+    // Render one step behind the simulation: the newest snapshot is shown in
+    // full exactly one step after it was published
+    double latency = Seconds(GameClock::now() - b.publishTime);
+    float f = (float)(latency / mStepSeconds);
+    f = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+    
+    size_t count = b.transforms.size();
+    out.resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        out[i] = Lerp(a.transforms[i], b.transforms[i], f);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mSlotMutex);
+        mReadSlots[0] = -1;
+        mReadSlots[1] = -1;
+    }
+    
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.lastSnapshotLatency = latency;
+    Accumulate(mStats.averageSnapshotLatency, latency);
+    return true;
+}
+
+void GameLoop::BeginRender()
+{
+    mRenderStart = GameClock::now();
+}
+
+void GameLoop::EndRender()
+{
+    double cost = Seconds(GameClock::now() - mRenderStart);
+    
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.lastRenderCost = cost;
+    Accumulate(mStats.averageRenderCost, cost);
+}
+
+GameLoopStats GameLoop::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    return mStats;
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,169 @@
+//
+//  JobSystem.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "JobSystem.h"
+
+namespace CookieEngine
+{
+
+static thread_local uint32_t sThreadIndex = 0;
+
+// Set while the thread runs a ParallelFor body, nested calls run inline
+static thread_local bool sInsideRange = false;
+
+JobSystem::JobSystem(uint32_t workerCount) : mWorkers(), mFunc(nullptr), mCount(0), mGrainSize(1),
+                                             mGeneration(0), mActiveWorkers(0), mQuit(false),
+                                             mNextIndex(0), mRemainingRanges(0)
+{
+    if(workerCount == 0)
+    {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    
+    mWorkers.reserve(workerCount);
+    for(uint32_t i = 0; i < workerCount; i++)
+    {
+        mWorkers.push_back(std::thread(&JobSystem::WorkerMain, this, i + 1));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mWakeCondition.notify_all();
+    
+    for(size_t i = 0; i < mWorkers.size(); i++)
+    {
+        mWorkers[i].join();
+    }
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+    return sThreadIndex;
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const RangeFunction& func)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    if(grainSize == 0)
+    {
+        grainSize = 1;
+    }
+    
+    // Not worth waking anybody up for a single range
+    if(count <= grainSize)
+    {
+        func(0, count);
+        return;
+    }
+    
+    // Without workers, or from inside a body whose batch holds the pool, the
+    // calling thread runs the ranges itself, still at most grainSize each
+    if(mWorkers.empty() || sInsideRange)
+    {
+        for(uint32_t begin = 0; begin < count; begin += grainSize)
+        {
+            func(begin, (count - begin) > grainSize ? begin + grainSize : count);
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> submitLock(mSubmitMutex);
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        
+        // Workers still holding on to the previous batch must leave before it is replaced
+        mDoneCondition.wait(lock, [this] { return mActiveWorkers == 0; });
+        
+        mFunc = &func;
+        mCount = count;
+        mGrainSize = grainSize;
+        mNextIndex.store(0);
+        mRemainingRanges.store((count + grainSize - 1) / grainSize);
+        mGeneration++;
+    }
+    mWakeCondition.notify_all();
+    
+    RunRanges(&func, count, grainSize);
+    
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this] { return mRemainingRanges.load() == 0; });
+    mFunc = nullptr;
+}
+
+void JobSystem::RunRanges(const RangeFunction* func, uint32_t count, uint32_t grainSize)
+{
+    for(;;)
+    {
+        uint32_t begin = mNextIndex.fetch_add(grainSize);
+        if(begin >= count)
+        {
+            break;
+        }
+        
+        uint32_t end = (count - begin) > grainSize ? begin + grainSize : count;
+        sInsideRange = true;
+        (*func)(begin, end);
+        sInsideRange = false;
+        
+        if(mRemainingRanges.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDoneCondition.notify_all();
+        }
+    }
+}
+
+void JobSystem::WorkerMain(uint32_t threadIndex)
+{
+    sThreadIndex = threadIndex;
+    uint64_t seenGeneration = 0;
+    
+    for(;;)
+    {
+        const RangeFunction* func;
+        uint32_t count;
+        uint32_t grainSize;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWakeCondition.wait(lock, [&] { return mQuit || mGeneration != seenGeneration; });
+            if(mQuit)
+            {
+                return;
+            }
+            
+            seenGeneration = mGeneration;
+            if(mFunc == nullptr)
+            {
+                continue;
+            }
+            
+            func = mFunc;
+            count = mCount;
+            grainSize = mGrainSize;
+            mActiveWorkers++;
+        }
+        
+        RunRanges(func, count, grainSize);
+        
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mActiveWorkers--;
+        }
+        mDoneCondition.notify_all();
+    }
+}
+
+} // namespace CookieEngine
@@ -0,0 +1,131 @@
+//
+//  Mesh.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Mesh.h"
+#include "MeshFile.h"
+
+namespace CookieEngine
+{
+    // Constructor
+    Mesh::Mesh() : mVertexArray(0), mVertexBuffer(0), mIndexBuffer(0), mIndexCount(0), mIndexType(GL_UNSIGNED_SHORT),
+                   mVertexStride(0), mAttributeCount(0), mBoundsMin(Vector3::Zero), mBoundsMax(Vector3::Zero)
+    {
+    }
+    
+    // Destructor
+    Mesh::~Mesh()
+    {
+        Release();
+    }
+    
+    void Mesh::Allocate(const MeshFileHeader& header)
+    {
+        Release();
+        
+        mIndexCount = header.indexCount;
+        mIndexType = header.indexSize == 4 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        mVertexStride = header.vertexStride;
+        mAttributeCount = header.attributeCount;
+        for(uint32_t i = 0; i < mAttributeCount; i++)
+        {
+            mAttributes[i] = header.attributes[i];
+        }
+        mBoundsMin = _mm_loadu_ps(header.boundsMin);
+        mBoundsMax = _mm_loadu_ps(header.boundsMax);
+        
+        // The vertex array records the index buffer and the attribute layout once, Bind only binds it
+        glGenVertexArrays(1, &mVertexArray);
+        glBindVertexArray(mVertexArray);
+        
+        glGenBuffers(1, &mVertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)header.vertexBytes, nullptr, GL_STATIC_DRAW);
+        
+        glGenBuffers(1, &mIndexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)header.indexBytes, nullptr, GL_STATIC_DRAW);
+        
+        for(uint32_t i = 0; i < mAttributeCount; i++)
+        {
+            const VertexAttributeDesc& desc = mAttributes[i];
+            GLuint location = (GLuint)desc.attribute;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, (GLint)desc.components, GL_FLOAT, GL_FALSE, (GLsizei)mVertexStride,
+                                  (const GLvoid*)(uintptr_t)desc.offset);
+        }
+        
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    
+    bool Mesh::Upload(const MeshFile& file)
+    {
+        if(!file.IsOpen())
+        {
+            return false;
+        }
+        
+        const MeshFileHeader& header = file.GetHeader();
+        Allocate(header);
+        
+        // Allocate sized the buffers, the mapped blobs already have the GPU layout and go in as they are
+        UploadVertices(file.GetVertexData(), 0, file.GetVertexDataSize());
+        UploadIndices(file.GetIndexData(), 0, file.GetIndexDataSize());
+        
+        return true;
+    }
+    
+    void Mesh::UploadVertices(const void* data, size_t offset, size_t size)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    
+    void Mesh::UploadIndices(const void* data, size_t offset, size_t size)
+    {
+        // The element array binding belongs to whatever vertex array is bound, the copy target leaves it alone
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mIndexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    
+    void Mesh::Release()
+    {
+        if(mVertexArray)
+        {
+            glDeleteVertexArrays(1, &mVertexArray);
+            mVertexArray = 0;
+        }
+        if(mVertexBuffer)
+        {
+            glDeleteBuffers(1, &mVertexBuffer);
+            mVertexBuffer = 0;
+        }
+        if(mIndexBuffer)
+        {
+            glDeleteBuffers(1, &mIndexBuffer);
+            mIndexBuffer = 0;
+        }
+        mIndexCount = 0;
+    }
+    
+    void Mesh::Bind() const
+    {
+        glBindVertexArray(mVertexArray);
+    }
+    
+    void Mesh::Unbind() const
+    {
+        glBindVertexArray(0);
+    }
+    
+    void Mesh::Draw() const
+    {
+        glDrawElements(GL_TRIANGLES, (GLsizei)mIndexCount, mIndexType, 0);
+    }
+} // namespace CookieEngine
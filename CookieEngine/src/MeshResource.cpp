@@ -0,0 +1,68 @@
+//
+//  MeshResource.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "MeshResource.h"
+
+#include <iostream>
+
+namespace CookieEngine
+{
+    MeshResource::MeshResource() : mFile(), mMesh(), mUploadOffset(0), mAllocated(false)
+    {
+    }
+    
+    bool MeshResource::Process(const void* data, size_t size)
+    {
+        if(!mFile.OpenFromMemory(data, size))
+        {
+            std::cerr << GetPath() << ": " << mFile.GetErrorLog() << "\n";
+            return false;
+        }
+        return true;
+    }
+    
+    size_t MeshResource::Upload(const void*, size_t, size_t budget, bool& done)
+    {
+        if(!mAllocated)
+        {
+            mMesh.Allocate(mFile.GetHeader());
+            mAllocated = true;
+        }
+        
+        // Vertices and indices are uploaded as one continuous stream of bytes
+        size_t vertexBytes = mFile.GetVertexDataSize();
+        size_t totalBytes = vertexBytes + mFile.GetIndexDataSize();
+        size_t uploaded = 0;
+        
+        while(mUploadOffset < totalBytes && uploaded < budget)
+        {
+            size_t slice = budget - uploaded;
+            if(mUploadOffset < vertexBytes)
+            {
+                slice = slice < vertexBytes - mUploadOffset ? slice : vertexBytes - mUploadOffset;
+                mMesh.UploadVertices(static_cast<const uint8_t*>(mFile.GetVertexData()) + mUploadOffset, mUploadOffset, slice);
+            }
+            else
+            {
+                size_t indexOffset = mUploadOffset - vertexBytes;
+                slice = slice < totalBytes - mUploadOffset ? slice : totalBytes - mUploadOffset;
+                mMesh.UploadIndices(static_cast<const uint8_t*>(mFile.GetIndexData()) + indexOffset, indexOffset, slice);
+            }
+            
+            mUploadOffset += slice;
+            uploaded += slice;
+        }
+        
+        done = mUploadOffset == totalBytes;
+        if(done)
+        {
+            // The staging memory is freed right after this
+            mFile.Close();
+        }
+        return uploaded;
+    }
+} // namespace CookieEngine
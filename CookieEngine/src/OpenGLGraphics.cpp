@@ -0,0 +1,140 @@
+//
+//  OpenGLGraphics.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "OpenGLGraphics.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CookieEngine
+{
+    namespace
+    {
+        const GLenum kPrimitiveModes[] = { GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES, GL_TRIANGLE_STRIP };
+        
+        void Clear(void*, uint32_t flags, const float* color, float depth)
+        {
+            GLbitfield mask = 0;
+            if(flags & ClearColor)
+            {
+                glClearColor(color[0], color[1], color[2], color[3]);
+                mask |= GL_COLOR_BUFFER_BIT;
+            }
+            if(flags & ClearDepth)
+            {
+                glClearDepth(depth);
+                mask |= GL_DEPTH_BUFFER_BIT;
+            }
+            if(flags & ClearStencil)
+            {
+                mask |= GL_STENCIL_BUFFER_BIT;
+            }
+            glClear(mask);
+        }
+        
+        void Viewport(void*, int32_t x, int32_t y, int32_t width, int32_t height)
+        {
+            glViewport(x, y, width, height);
+        }
+        
+        void UseProgram(void*, uint32_t program)
+        {
+            glUseProgram(program);
+        }
+        
+        void Uniform(void*, int32_t location, UniformType type, uint32_t count, const void* values)
+        {
+            const GLfloat* floats = static_cast<const GLfloat*>(values);
+            switch(type)
+            {
+                case UniformType::Float:
+                    glUniform1fv(location, (GLsizei)count, floats);
+                    break;
+                case UniformType::Float2:
+                    glUniform2fv(location, (GLsizei)count, floats);
+                    break;
+                case UniformType::Float3:
+                    glUniform3fv(location, (GLsizei)count, floats);
+                    break;
+                case UniformType::Float4:
+                    glUniform4fv(location, (GLsizei)count, floats);
+                    break;
+                case UniformType::Int:
+                    glUniform1iv(location, (GLsizei)count, static_cast<const GLint*>(values));
+                    break;
+                case UniformType::Matrix4:
+                    // Matrix4 is row-major, GL expects columns
+                    glUniformMatrix4fv(location, (GLsizei)count, GL_TRUE, floats);
+                    break;
+            }
+        }
+        
+        void BindVertexArray(void*, uint32_t vertexArray)
+        {
+            glBindVertexArray(vertexArray);
+        }
+        
+        void BindTexture(void*, uint32_t unit, uint32_t texture)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+        
+        void BindUniformBuffer(void*, uint32_t binding, uint32_t buffer)
+        {
+            glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        }
+        
+        void DrawArrays(void*, PrimitiveType primitive, uint32_t first, uint32_t count, uint32_t instanceCount)
+        {
+            GLenum mode = kPrimitiveModes[(int)primitive];
+            if(instanceCount == 1)
+            {
+                glDrawArrays(mode, (GLint)first, (GLsizei)count);
+            }
+            else
+            {
+                glDrawArraysInstanced(mode, (GLint)first, (GLsizei)count, (GLsizei)instanceCount);
+            }
+        }
+        
+        void DrawElements(void*, PrimitiveType primitive, IndexType indexType, uint32_t firstIndex,
+                          uint32_t count, uint32_t instanceCount)
+        {
+            GLenum mode = kPrimitiveModes[(int)primitive];
+            GLenum type = indexType == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            size_t offset = (size_t)firstIndex * (indexType == IndexType::UInt16 ? 2 : 4);
+            if(instanceCount == 1)
+            {
+                glDrawElements(mode, (GLsizei)count, type, (const GLvoid*)offset);
+            }
+            else
+            {
+                glDrawElementsInstanced(mode, (GLsizei)count, type, (const GLvoid*)offset, (GLsizei)instanceCount);
+            }
+        }
+    } // namespace
+    
+    GraphicsFunctions GetOpenGLFunctions()
+    {
+        GraphicsFunctions functions;
+        functions.context = nullptr;
+        functions.clear = Clear;
+        functions.viewport = Viewport;
+        functions.useProgram = UseProgram;
+        functions.uniform = Uniform;
+        functions.bindVertexArray = BindVertexArray;
+        functions.bindTexture = BindTexture;
+        functions.bindUniformBuffer = BindUniformBuffer;
+        functions.drawArrays = DrawArrays;
+        functions.drawElements = DrawElements;
+        return functions;
+    }
+} // namespace CookieEngine
@@ -0,0 +1,109 @@
+//
+//  ParticleRenderer.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ParticleRenderer.h"
+#include "ShaderProgram.h"
+
+#include <cstddef>
+
+namespace CookieEngine
+{
+    // Constructor
+    ParticleRenderer::ParticleRenderer() : mVertexArray(0), mVertexBuffer(0), mCapacity(0), mVertexCount(0)
+    {
+    }
+    
+    // Destructor
+    ParticleRenderer::~ParticleRenderer()
+    {
+        Release();
+    }
+    
+    void ParticleRenderer::Stream(const ParticleSystem& system, JobSystem* jobs)
+    {
+        if(mVertexBuffer == 0)
+        {
+            glGenBuffers(1, &mVertexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+            
+            // Resizing the buffer keeps its name, so the layout is recorded once
+            glGenVertexArrays(1, &mVertexArray);
+            glBindVertexArray(mVertexArray);
+            glEnableVertexAttribArray(kParticlePositionLocation);
+            glEnableVertexAttribArray(kParticleColorLocation);
+            glVertexAttribPointer(kParticlePositionLocation, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
+                                  (const GLvoid*)offsetof(ParticleVertex, position));
+            glVertexAttribPointer(kParticleColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
+                                  (const GLvoid*)offsetof(ParticleVertex, color));
+            glBindVertexArray(0);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        
+        // Sized for the whole particle buffer so it never has to grow mid effect
+        uint32_t capacity = system.GetBuffer().GetCapacity();
+        if(capacity != mCapacity)
+        {
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(capacity * sizeof(ParticleVertex)), nullptr, GL_STREAM_DRAW);
+            mCapacity = capacity;
+        }
+        
+        mVertexCount = 0;
+        uint32_t count = system.GetAliveCount();
+        if(count > 0)
+        {
+            // The job threads write straight into the mapping, GL calls stay on this thread
+            void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * sizeof(ParticleVertex)),
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if(mapped)
+            {
+                mVertexCount = system.WriteVertices(static_cast<ParticleVertex*>(mapped), count, jobs);
+                if(glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+                {
+                    // Contents were lost, e.g. on a display mode change. Skip this frame.
+                    mVertexCount = 0;
+                }
+            }
+        }
+        
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    
+    void ParticleRenderer::Draw(ShaderProgram& program) const
+    {
+        if(mVertexCount == 0)
+        {
+            return;
+        }
+        
+        program.use();
+        
+        // The core context always fills gl_PointCoord, only the shader written size needs enabling
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        
+        glBindVertexArray(mVertexArray);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)mVertexCount);
+        glBindVertexArray(0);
+        
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+    
+    void ParticleRenderer::Release()
+    {
+        if(mVertexArray)
+        {
+            glDeleteVertexArrays(1, &mVertexArray);
+            mVertexArray = 0;
+        }
+        if(mVertexBuffer)
+        {
+            glDeleteBuffers(1, &mVertexBuffer);
+            mVertexBuffer = 0;
+        }
+        mCapacity = 0;
+        mVertexCount = 0;
+    }
+} // namespace CookieEngine
@@ -122,6 +122,17 @@ namespace CookieEngine
         glBindAttribLocation(mObject, location, name);
     }
     
+    bool ShaderProgram::bindUniformBlock(const GLchar* name, GLuint binding)
+    {
+        GLuint index = glGetUniformBlockIndex(mObject, name);
+        if(index == GL_INVALID_INDEX)
+        {
+            return false;
+        }
+        glUniformBlockBinding(mObject, index, binding);
+        return true;
+    }
+    
     GLint ShaderProgram::getUniformLocation(const GLchar* name)
     {
         return glGetUniformLocation(mObject, name);
@@ -194,4 +205,17 @@ namespace CookieEngine
         }
         glUniform1i(getUniformLocation(name), (int)x);
     }
+    
+    void ShaderProgram::setUniform(const GLchar* name, const Matrix4& m)
+    {
+        if(!isInUse())
+        {
+            use();
+        }
+        float values[16];
+        m.Store(values);
+        
+        // Matrix4 is row-major, GL expects columns
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_TRUE, values);
+    }
 } // namespace CookieEngine
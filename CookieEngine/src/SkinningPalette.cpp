@@ -0,0 +1,64 @@
+//
+//  SkinningPalette.cpp
+//  CookieEngine
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "SkinningPalette.h"
+
+namespace CookieEngine
+{
+    // Constructor
+    SkinningPalette::SkinningPalette() : mBuffer(0), mJointCount(0)
+    {
+    }
+    
+    // Destructor
+    SkinningPalette::~SkinningPalette()
+    {
+        Release();
+    }
+    
+    bool SkinningPalette::Upload(const Matrix4* palette, uint32_t count)
+    {
+        if(count > kMaxPaletteJoints)
+        {
+            return false;
+        }
+        
+        if(mBuffer == 0)
+        {
+            // Sized for the whole block once, later uploads only touch the used joints
+            glGenBuffers(1, &mBuffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+            glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)(kMaxPaletteJoints * sizeof(Matrix4)), nullptr, GL_DYNAMIC_DRAW);
+        }
+        else
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        }
+        
+        // Matrix4 is 16 aligned rows of 4 floats, the std140 layout of a row_major mat4
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)(count * sizeof(Matrix4)), palette);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        
+        mJointCount = count;
+        return true;
+    }
+    
+    void SkinningPalette::Bind(GLuint binding) const
+    {
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, mBuffer);
+    }
+    
+    void SkinningPalette::Release()
+    {
+        if(mBuffer)
+        {
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+        mJointCount = 0;
+    }
+} // namespace CookieEngine
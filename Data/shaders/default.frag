@@ -1,8 +1,10 @@
-#version 120
+#version 140
 
-varying vec3 fragColor;
+in vec3 fragColor;
+
+out vec4 outColor;
 
 void main()
 {
-	gl_FragColor = vec4(fragColor, 1.0);
+	outColor = vec4(fragColor, 1.0);
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
-#version 120
+#version 140
 
-attribute vec2 vertPosition;
-attribute vec3 vertColor;
+in vec2 vertPosition;
+in vec3 vertColor;
 
-varying vec3 fragColor;
+uniform mat4 model;
+
+out vec3 fragColor;
 
 void main()
 {
 	fragColor = vertColor;
-	gl_Position = vec4(vertPosition, 0.0, 1.0);
+	gl_Position = model * vec4(vertPosition, 0.0, 1.0);
 }
\ No newline at end of file
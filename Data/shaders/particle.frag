@@ -0,0 +1,13 @@
+#version 140
+
+in vec4 fragColor;
+
+out vec4 outColor;
+
+void main()
+{
+	// Round soft sprite
+	vec2 offset = gl_PointCoord * 2.0 - 1.0;
+	float falloff = max(1.0 - dot(offset, offset), 0.0);
+	outColor = vec4(fragColor.rgb, fragColor.a * falloff);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 140
+
+// xyz is the position, w the point size in pixels at distance 1
+in vec4 vertPositionSize;
+in vec4 vertColor;
+
+uniform mat4 viewProjection;
+
+out vec4 fragColor;
+
+void main()
+{
+	fragColor = vertColor;
+	gl_Position = viewProjection * vec4(vertPositionSize.xyz, 1.0);
+	gl_PointSize = vertPositionSize.w / max(gl_Position.w, 0.0001);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 140
+
+in vec3 fragNormal;
+
+out vec4 outColor;
+
+void main()
+{
+	float light = max(dot(normalize(fragNormal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+	outColor = vec4(vec3(0.2 + 0.8 * light), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 140
+
+#define MAX_JOINTS 128
+
+// Locations match CookieEngine::VertexAttribute, bind them before linking
+in vec3 vertPosition;
+in vec3 vertNormal;
+in vec4 vertJoints;
+in vec4 vertWeights;
+
+layout(std140, row_major) uniform SkinningPalette
+{
+	mat4 joints[MAX_JOINTS];
+};
+
+uniform mat4 modelViewProjection;
+
+out vec3 fragNormal;
+
+void main()
+{
+	mat4 skin = joints[int(vertJoints.x)] * vertWeights.x;
+	skin += joints[int(vertJoints.y)] * vertWeights.y;
+	skin += joints[int(vertJoints.z)] * vertWeights.z;
+	skin += joints[int(vertJoints.w)] * vertWeights.w;
+
+	fragNormal = mat3(skin) * vertNormal;
+	gl_Position = modelViewProjection * (skin * vec4(vertPosition, 1.0));
+}
\ No newline at end of file
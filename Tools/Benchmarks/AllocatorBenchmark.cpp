@@ -0,0 +1,84 @@
+//
+//  AllocatorBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Allocates and frees 1M SIMD sized blocks with malloc and the engine allocators
+//  build: g++ -std=c++11 -O2 -msse4.1 -DNDEBUG -ICookieEngine/Memory/include
+//         Tools/Benchmarks/AllocatorBenchmark.cpp CookieEngine/Memory/src/*.cpp
+//
+
+#include <cstdlib>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CookieMemory.h"
+
+static const uint32_t kAllocationCount = 1000000;
+static const int kRepeatCount = 10;
+
+// Size of a Matrix4, the most common SIMD allocation
+static const size_t kBlockSize = 64;
+
+int main() {
+    std::vector<void*> blocks(kAllocationCount);
+    printf("%u allocations of %zu bytes, allocate all then free all\n", kAllocationCount, kBlockSize);
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            blocks[i] = malloc(kBlockSize);
+        }
+        Benchmarks::KeepAlive(blocks[0]);
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            free(blocks[i]);
+        }
+    });
+    Benchmarks::PrintResult("malloc / free", seconds, kAllocationCount, "allocations/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            blocks[i] = CookieEngine::AlignedMalloc(kBlockSize, CookieEngine::kSimdAlignment);
+        }
+        Benchmarks::KeepAlive(blocks[0]);
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            CookieEngine::AlignedFree(blocks[i]);
+        }
+    });
+    Benchmarks::PrintResult("AlignedMalloc / AlignedFree", seconds, kAllocationCount, "allocations/ms");
+    
+    CookieEngine::PoolAllocator pool(kBlockSize, CookieEngine::kSimdAlignment, 4096, "Benchmark");
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            blocks[i] = pool.Allocate();
+        }
+        Benchmarks::KeepAlive(blocks[0]);
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            pool.Free(blocks[i]);
+        }
+    });
+    Benchmarks::PrintResult("PoolAllocator", seconds, kAllocationCount, "allocations/ms");
+    
+    CookieEngine::LinearAllocator arena(kAllocationCount * kBlockSize, "Benchmark");
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t i = 0; i < kAllocationCount; i++)
+        {
+            blocks[i] = arena.Allocate(kBlockSize);
+        }
+        Benchmarks::KeepAlive(blocks[0]);
+        arena.Reset();
+    });
+    Benchmarks::PrintResult("LinearAllocator", seconds, kAllocationCount, "allocations/ms");
+    
+    return 0;
+}
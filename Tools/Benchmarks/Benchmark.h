@@ -0,0 +1,47 @@
+//
+//  Benchmark.h
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef Benchmarks_Benchmark_h
+#define Benchmarks_Benchmark_h
+
+#include <chrono>
+#include <cstdio>
+
+namespace Benchmarks
+{
+
+// Runs func repeatCount times and returns the fastest run in seconds. The
+// fastest run is the one least disturbed by the OS and cold caches.
+template<typename Func>
+double MeasureBest(int repeatCount, Func func)
+{
+    double best = 1e30;
+    for(int i = 0; i < repeatCount; i++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        func();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+// Keeps the compiler from dropping work whose result is otherwise unused
+template<typename T>
+void KeepAlive(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+__attribute__((always_inline)) inline void PrintResult(const char* name, double seconds, double items, const char* unit)
+{
+    printf("%-36s %10.3f ms %12.1f %s\n", name, seconds * 1e3, items / (seconds * 1e3), unit);
+}
+
+} // namespace Benchmarks
+
+#endif
@@ -0,0 +1,78 @@
+//
+//  BroadphaseBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Measures pair generation of sweep and prune and the spatial hash grid for 10k to 100k bodies
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include -ICookieEngine/Collision/include -ICookieEngine/Resource/include
+//         Tools/Benchmarks/BroadphaseBenchmark.cpp CookieEngine/Collision/src/*.cpp CookieEngine/Math/src/*.cpp
+//         CookieEngine/Memory/src/*.cpp CookieEngine/Resource/src/MeshFile.cpp CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Collision.h"
+#include "JobSystem.h"
+
+static const uint32_t kBodyCounts[] = { 10000, 30000, 100000 };
+static const int kRepeatCount = 5;
+
+// Cubes with half extents in [0.2, 1], spread so there are about 2.5 cells
+// of space along each axis per body and the pair count grows linearly
+static const float kSpacing = 5.0f;
+static const float kCellSize = 2.0f;
+
+static float Random()
+{
+    return (float)rand() / (float)RAND_MAX;
+}
+
+static void FillBodies(CookieEngine::AabbSet& bodies, uint32_t count)
+{
+    float world = kSpacing * cbrtf((float)count);
+    bodies.Resize(count);
+    for(uint32_t i = 0; i < count; i++)
+    {
+        CookieEngine::Vector3 center(Random() * world, Random() * world, Random() * world);
+        float half = 0.2f + Random() * 0.8f;
+        CookieEngine::Vector3 extents(half, half, half);
+        bodies.Set(i, center - extents, center + extents);
+    }
+}
+
+int main() {
+    CookieEngine::JobSystem jobs;
+    printf("%u job threads\n", jobs.GetThreadCount());
+    
+    CookieEngine::AabbSet bodies;
+    std::vector<CookieEngine::BroadphasePair> pairs;
+    for(size_t i = 0; i < sizeof(kBodyCounts) / sizeof(kBodyCounts[0]); i++)
+    {
+        uint32_t count = kBodyCounts[i];
+        srand(1);
+        FillBodies(bodies, count);
+        
+        // Sweep and prune keeps its sort order between frames, the first call pays for a full sort
+        CookieEngine::SweepAndPrune sweepAndPrune;
+        sweepAndPrune.FindPairs(bodies, pairs, &jobs);
+        double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+        {
+            sweepAndPrune.FindPairs(bodies, pairs, &jobs);
+        });
+        printf("%u bodies, %zu pairs\n", count, pairs.size());
+        Benchmarks::PrintResult("  Sweep and prune", seconds, (double)count, "bodies/ms");
+        
+        CookieEngine::SpatialHashGrid grid(kCellSize);
+        seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+        {
+            grid.FindPairs(bodies, pairs, &jobs);
+        });
+        Benchmarks::PrintResult("  Spatial hash grid", seconds, (double)count, "bodies/ms");
+    }
+    return 0;
+}
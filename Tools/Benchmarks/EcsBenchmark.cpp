@@ -0,0 +1,106 @@
+//
+//  EcsBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Iterates 1M entities stored in ECS chunks and as an array of game objects
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/ECS/include
+//         -ICookieEngine/Memory/include Tools/Benchmarks/EcsBenchmark.cpp CookieEngine/ECS/src/*.cpp
+//         CookieEngine/Memory/src/*.cpp CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include <vector>
+
+#include "Benchmark.h"
+#include "ECS.h"
+
+static const uint32_t kEntityCount = 1000000;
+static const int kRepeatCount = 10;
+static const float kStep = 1.0f / 60.0f;
+
+struct Position
+{
+    float x, y, z;
+};
+
+struct Velocity
+{
+    float x, y, z;
+};
+
+struct Health
+{
+    float current, max;
+};
+
+// The baseline: everything an entity owns in one object, iterated as an array
+struct GameObject
+{
+    float transform[16];
+    Position position;
+    Velocity velocity;
+    Health health;
+    uint32_t flags;
+    void* userData;
+};
+
+int main() {
+    std::vector<GameObject> objects(kEntityCount);
+    CookieEngine::World world;
+    for(uint32_t i = 0; i < kEntityCount; i++)
+    {
+        float f = (float)(i % 1000);
+        Position position = { f, 0.0f, -f };
+        Velocity velocity = { 1.0f, f * 0.01f, 0.5f };
+        Health health = { 100.0f, 100.0f };
+        
+        objects[i].position = position;
+        objects[i].velocity = velocity;
+        objects[i].health = health;
+        world.CreateEntity(position, velocity, health);
+    }
+    
+    CookieEngine::JobSystem jobs;
+    CookieEngine::Query<Position, const Velocity> query(world);
+    printf("%u entities, %u job threads\n", kEntityCount, jobs.GetThreadCount());
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(size_t i = 0; i < objects.size(); i++)
+        {
+            objects[i].position.x += objects[i].velocity.x * kStep;
+            objects[i].position.y += objects[i].velocity.y * kStep;
+            objects[i].position.z += objects[i].velocity.z * kStep;
+        }
+    });
+    Benchmarks::KeepAlive(objects[kEntityCount / 2].position);
+    Benchmarks::PrintResult("AoS game objects", seconds, kEntityCount, "entities/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        query.ForEach([](Position& position, const Velocity& velocity)
+        {
+            position.x += velocity.x * kStep;
+            position.y += velocity.y * kStep;
+            position.z += velocity.z * kStep;
+        });
+    });
+    Benchmarks::PrintResult("ECS Query::ForEach", seconds, kEntityCount, "entities/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        query.ParallelForEachChunk(jobs, [](const CookieEngine::Entity*, uint32_t count, Position* positions, const Velocity* velocities)
+        {
+            for(uint32_t i = 0; i < count; i++)
+            {
+                positions[i].x += velocities[i].x * kStep;
+                positions[i].y += velocities[i].y * kStep;
+                positions[i].z += velocities[i].z * kStep;
+            }
+        });
+    });
+    Benchmarks::PrintResult("ECS Query::ParallelForEachChunk", seconds, kEntityCount, "entities/ms");
+    
+    return 0;
+}
@@ -0,0 +1,161 @@
+//
+//  MathBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Times m = a * s + b * t - c and a nested Lerp as MatrixExpression trees against the same math done
+//  with the in-place Add, Sub and Multiply, and checks that both give the same matrices.
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include Tools/Benchmarks/MathBenchmark.cpp CookieEngine/Math/src/*.cpp
+//         CookieEngine/Memory/src/*.cpp
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "AlignedAllocator.h"
+#include "Benchmark.h"
+#include "CookieMath.h"
+
+static const uint32_t kMatrixCount = 1024;     // 5 arrays of 64 KB, all in L2
+static const uint32_t kPassCount = 500;
+static const uint32_t kFactorCount = 64;
+static const int kRepeatCount = 10;
+
+// The in-place API has no scalar multiply, a diagonal matrix stands in for it
+static CookieEngine::Matrix4 Diagonal(float s)
+{
+    return CookieEngine::Matrix4(s, 0.0f, 0.0f, 0.0f, 0.0f, s, 0.0f, 0.0f, 0.0f, 0.0f, s, 0.0f, 0.0f, 0.0f, 0.0f, s);
+}
+
+// a * (1 - f) + b * f with a temporary for b
+static void LerpInPlace(CookieEngine::Matrix4& a, const CookieEngine::Matrix4& b, const CookieEngine::Matrix4& scaleA,
+                        const CookieEngine::Matrix4& scaleB)
+{
+    CookieEngine::Matrix4 scaled = b;
+    scaled.Multiply(scaleB);
+    a.Multiply(scaleA);
+    a.Add(scaled);
+}
+
+static float MaxDifference(const CookieEngine::AlignedVector<CookieEngine::Matrix4>& lhs,
+                           const CookieEngine::AlignedVector<CookieEngine::Matrix4>& rhs)
+{
+    float difference = 0.0f;
+    for(size_t i = 0; i < lhs.size(); i++)
+    {
+        float a[16];
+        float b[16];
+        lhs[i].Store(a);
+        rhs[i].Store(b);
+        for(int j = 0; j < 16; j++)
+        {
+            difference = std::max(difference, std::fabs(a[j] - b[j]));
+        }
+    }
+    return difference;
+}
+
+int main() {
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> a(kMatrixCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> b(kMatrixCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> c(kMatrixCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> d(kMatrixCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> expression(kMatrixCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> inPlace(kMatrixCount);
+    for(uint32_t i = 0; i < kMatrixCount; i++)
+    {
+        a[i].CreateRotationY(i * 0.01f);
+        b[i].CreateRotationZ(i * 0.02f);
+        c[i].CreateTranslation(CookieEngine::Vector3(i * 0.1f, 1.0f, -2.0f));
+        d[i].CreateScale(1.0f + i * 0.001f);
+    }
+    
+    // Factors change per matrix so neither side can fold them into constants
+    float factors[kFactorCount];
+    CookieEngine::Matrix4 diagonals[kFactorCount];
+    CookieEngine::Matrix4 complements[kFactorCount];
+    for(uint32_t i = 0; i < kFactorCount; i++)
+    {
+        factors[i] = (i + 0.5f) / kFactorCount;
+        diagonals[i] = Diagonal(factors[i]);
+        complements[i] = Diagonal(1.0f - factors[i]);
+    }
+    double matrices = (double)kMatrixCount * kPassCount;
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t pass = 0; pass < kPassCount; pass++)
+        {
+            for(uint32_t i = 0; i < kMatrixCount; i++)
+            {
+                float s = factors[i % kFactorCount];
+                float t = factors[(i + 7) % kFactorCount];
+                expression[i] = a[i] * s + b[i] * t - c[i];
+            }
+            Benchmarks::KeepAlive(expression[0]);
+        }
+    });
+    Benchmarks::PrintResult("a * s + b * t - c, expression", seconds, matrices, "matrices/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t pass = 0; pass < kPassCount; pass++)
+        {
+            for(uint32_t i = 0; i < kMatrixCount; i++)
+            {
+                CookieEngine::Matrix4 scaled = b[i];
+                scaled.Multiply(diagonals[(i + 7) % kFactorCount]);
+                inPlace[i] = a[i];
+                inPlace[i].Multiply(diagonals[i % kFactorCount]);
+                inPlace[i].Add(scaled);
+                inPlace[i].Sub(c[i]);
+            }
+            Benchmarks::KeepAlive(inPlace[0]);
+        }
+    });
+    Benchmarks::PrintResult("a * s + b * t - c, in place", seconds, matrices, "matrices/ms");
+    float difference = MaxDifference(expression, inPlace);
+    
+    // Lerp(Lerp(a, b, f), Lerp(c, d, g), h), the blend of two blends an animation mixer does
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t pass = 0; pass < kPassCount; pass++)
+        {
+            for(uint32_t i = 0; i < kMatrixCount; i++)
+            {
+                float f = factors[i % kFactorCount];
+                float g = factors[(i + 7) % kFactorCount];
+                float h = factors[(i + 13) % kFactorCount];
+                expression[i] = Lerp(Lerp(a[i], b[i], f), Lerp(c[i], d[i], g), h);
+            }
+            Benchmarks::KeepAlive(expression[0]);
+        }
+    });
+    Benchmarks::PrintResult("Nested Lerp, expression", seconds, matrices, "matrices/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        for(uint32_t pass = 0; pass < kPassCount; pass++)
+        {
+            for(uint32_t i = 0; i < kMatrixCount; i++)
+            {
+                uint32_t f = i % kFactorCount;
+                uint32_t g = (i + 7) % kFactorCount;
+                uint32_t h = (i + 13) % kFactorCount;
+                CookieEngine::Matrix4 blend = c[i];
+                LerpInPlace(blend, d[i], complements[g], diagonals[g]);
+                inPlace[i] = a[i];
+                LerpInPlace(inPlace[i], b[i], complements[f], diagonals[f]);
+                LerpInPlace(inPlace[i], blend, complements[h], diagonals[h]);
+            }
+            Benchmarks::KeepAlive(inPlace[0]);
+        }
+    });
+    Benchmarks::PrintResult("Nested Lerp, in place", seconds, matrices, "matrices/ms");
+    difference = std::max(difference, MaxDifference(expression, inPlace));
+    
+    printf("Largest difference between expression and in place results: %g\n", difference);
+    return difference < 1e-4f ? 0 : 1;
+}
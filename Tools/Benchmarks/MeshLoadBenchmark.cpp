@@ -0,0 +1,102 @@
+//
+//  MeshLoadBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Loads a 512x512 grid mesh from OBJ text and from a memory mapped .cmesh
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/Math/include -ICookieEngine/Resource/include
+//         -ITools/MeshConverter Tools/Benchmarks/MeshLoadBenchmark.cpp Tools/MeshConverter/ObjImporter.cpp
+//         Tools/MeshConverter/MeshData.cpp CookieEngine/Resource/src/MeshFile.cpp CookieEngine/Math/src/*.cpp
+//
+
+#include <cstdint>
+#include <fstream>
+
+#include "Benchmark.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "ObjImporter.h"
+
+static const uint32_t kGridSize = 512;
+static const int kRepeatCount = 5;
+static const char* kObjPath = "MeshLoadBenchmark.obj";
+static const char* kMeshPath = "MeshLoadBenchmark.cmesh";
+
+// Writes a heightfield with positions, normals and texture coordinates
+static void WriteGridObj(const char* path)
+{
+    std::ofstream file(path);
+    for(uint32_t y = 0; y <= kGridSize; y++)
+    {
+        for(uint32_t x = 0; x <= kGridSize; x++)
+        {
+            file << "v " << x << " " << ((x * 7 + y * 13) % 17) * 0.1f << " " << y << "\n";
+            file << "vt " << (float)x / kGridSize << " " << (float)y / kGridSize << "\n";
+        }
+    }
+    file << "vn 0 1 0\n";
+    
+    for(uint32_t y = 0; y < kGridSize; y++)
+    {
+        for(uint32_t x = 0; x < kGridSize; x++)
+        {
+            uint32_t i = y * (kGridSize + 1) + x + 1;
+            uint32_t j = i + kGridSize + 1;
+            file << "f " << i << "/" << i << "/1 " << j << "/" << j << "/1 " << i + 1 << "/" << i + 1 << "/1\n";
+            file << "f " << i + 1 << "/" << i + 1 << "/1 " << j << "/" << j << "/1 " << j + 1 << "/" << j + 1 << "/1\n";
+        }
+    }
+}
+
+int main() {
+    std::string error;
+    MeshConverter::MeshData mesh;
+    WriteGridObj(kObjPath);
+    if(!MeshConverter::ImportObj(kObjPath, mesh, error) || !MeshConverter::WriteMeshFile(kMeshPath, mesh, error))
+    {
+        printf("%s\n", error.c_str());
+        return -1;
+    }
+    printf("%u vertices, %zu triangles\n", mesh.GetVertexCount(), mesh.indices.size() / 3);
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        MeshConverter::MeshData parsed;
+        MeshConverter::ImportObj(kObjPath, parsed, error);
+        Benchmarks::KeepAlive(parsed.vertices[0]);
+    });
+    Benchmarks::PrintResult("OBJ text parse", seconds, mesh.GetVertexCount(), "vertices/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        CookieEngine::MeshFile file;
+        file.Open(kMeshPath);
+        Benchmarks::KeepAlive(file.GetHeader().vertexCount);
+    });
+    Benchmarks::PrintResult(".cmesh Open", seconds, mesh.GetVertexCount(), "vertices/ms");
+    
+    // Mapping is lazy, reading every page is what handing the blobs to glBufferData costs on the CPU
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        CookieEngine::MeshFile file;
+        file.Open(kMeshPath);
+        const uint8_t* data = (const uint8_t*)file.GetVertexData();
+        uint32_t sum = 0;
+        for(size_t i = 0; i < file.GetVertexDataSize(); i += 4096)
+        {
+            sum += data[i];
+        }
+        data = (const uint8_t*)file.GetIndexData();
+        for(size_t i = 0; i < file.GetIndexDataSize(); i += 4096)
+        {
+            sum += data[i];
+        }
+        Benchmarks::KeepAlive(sum);
+    });
+    Benchmarks::PrintResult(".cmesh Open and touch every page", seconds, mesh.GetVertexCount(), "vertices/ms");
+    
+    remove(kObjPath);
+    remove(kMeshPath);
+    return 0;
+}
@@ -0,0 +1,108 @@
+//
+//  OcclusionBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Rasterizes 20 occluders of 100 triangles, then tests 10k boxes against them and reports the OcclusionStats
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include -ICookieEngine/Render/include Tools/Benchmarks/OcclusionBenchmark.cpp
+//         CookieEngine/Render/src/OcclusionCuller.cpp CookieEngine/Render/src/RasterKernels.cpp
+//         CookieEngine/Math/src/*.cpp CookieEngine/Memory/src/*.cpp CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "OcclusionCuller.h"
+#include "Vector3.h"
+
+static const uint32_t kOccluderCount = 20;
+static const uint32_t kOccluderTriangles = 100;
+static const uint32_t kBoxCount = 10000;
+static const int kRepeatCount = 20;
+
+static float Random(float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+int main() {
+    // Occluders are clusters of random triangles in front of the camera, boxes spread out behind them
+    srand(1);
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    for(uint32_t i = 0; i < kOccluderCount * kOccluderTriangles; i++)
+    {
+        float x = Random(-10.0f, 10.0f);
+        float y = Random(-10.0f, 10.0f);
+        float z = Random(-5.0f, 15.0f);
+        for(uint32_t v = 0; v < 3; v++)
+        {
+            positions.push_back(x + Random(0.0f, 2.0f));
+            positions.push_back(y + Random(0.0f, 2.0f));
+            positions.push_back(z + Random(0.0f, 2.0f));
+        }
+        uint32_t first = (i % kOccluderTriangles) * 3;
+        uint32_t triangle[3] = { first, first + 1, first + 2 };
+        indices.insert(indices.end(), triangle, triangle + 3);
+    }
+    
+    std::vector<CookieEngine::Vector3> mins;
+    std::vector<CookieEngine::Vector3> maxs;
+    for(uint32_t i = 0; i < kBoxCount; i++)
+    {
+        CookieEngine::Vector3 min(Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(0.0f, 30.0f));
+        mins.push_back(min);
+        maxs.push_back(min + CookieEngine::Vector3(0.5f, 0.5f, 0.5f));
+    }
+    std::vector<char> visible(kBoxCount);
+    
+    CookieEngine::Matrix4 view;
+    CookieEngine::Matrix4 projection;
+    view.CreateLookAt(CookieEngine::Vector3(0.0f, 0.0f, -10.0f), CookieEngine::Vector3::Zero, CookieEngine::Vector3::Up);
+    projection.CreatePerspective(1.0f, 16.0f / 9.0f, 0.5f, 100.0f);
+    CookieEngine::Matrix4 viewProjection = Concatenate(projection, view);
+    
+    CookieEngine::JobSystem jobs;
+    CookieEngine::OcclusionCuller culler;
+    printf("%u job threads, %ux%u depth buffer\n", jobs.GetThreadCount(), culler.GetWidth(), culler.GetHeight());
+    
+    CookieEngine::JobSystem* const modes[2] = { nullptr, &jobs };
+    const char* const modeNames[2] = { "calling thread", "jobs" };
+    for(int m = 0; m < 2; m++)
+    {
+        // rasterizeTime covers setup, binning and rasterization but not AddOccluder, which copies nothing
+        double rasterizeTime = 1e30;
+        double testTime = 1e30;
+        for(int i = 0; i < kRepeatCount; i++)
+        {
+            culler.BeginFrame(viewProjection);
+            for(uint32_t o = 0; o < kOccluderCount; o++)
+            {
+                culler.AddOccluder(&positions[o * kOccluderTriangles * 9], 3 * sizeof(float), kOccluderTriangles * 3,
+                                   &indices[o * kOccluderTriangles * 3], kOccluderTriangles,
+                                   CookieEngine::Matrix4::Identity);
+            }
+            culler.RasterizeOccluders(modes[m]);
+            rasterizeTime = std::min(rasterizeTime, culler.GetStats().rasterizeTime);
+            
+            testTime = std::min(testTime, Benchmarks::MeasureBest(1, [&]
+            {
+                culler.TestVisibility(mins.data(), maxs.data(), kBoxCount, (bool*)visible.data(), modes[m]);
+            }));
+        }
+        
+        const CookieEngine::OcclusionStats& stats = culler.GetStats();
+        printf("%s, %u wide SIMD: %u occluders, %u of %u triangles rasterized, %u of %u boxes culled\n", modeNames[m],
+               stats.simdWidth, stats.occluderCount, stats.rasterizedTriangles, stats.occluderTriangles,
+               stats.culledCount, stats.testedCount);
+        Benchmarks::PrintResult("RasterizeOccluders", rasterizeTime, stats.rasterizedTriangles, "triangles/ms");
+        Benchmarks::PrintResult("TestVisibility", testTime, kBoxCount, "boxes/ms");
+    }
+    
+    return 0;
+}
@@ -0,0 +1,66 @@
+//
+//  ParticleBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Updates 1M particles and writes their vertices
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include -ICookieEngine/Particles/include Tools/Benchmarks/ParticleBenchmark.cpp
+//         CookieEngine/Particles/src/*.cpp CookieEngine/Math/src/*.cpp CookieEngine/Memory/src/*.cpp
+//         CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include <vector>
+
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "ParticleSystem.h"
+
+static const uint32_t kParticleCount = 1000000;
+static const int kRepeatCount = 20;
+static const float kStep = 1.0f / 60.0f;
+
+// Lifetimes average 10 s, the emitter replaces the particles that die so
+// every update sees about kParticleCount of them
+static const float kLifetimeMin = 5.0f;
+static const float kLifetimeMax = 15.0f;
+
+static void Run(const char* name, CookieEngine::JobSystem* jobs)
+{
+    CookieEngine::ParticleSystem particles(kParticleCount + kParticleCount / 10);
+    CookieEngine::ParticleEmitter emitter;
+    emitter.positionSpread = CookieEngine::Vector3(10.0f, 10.0f, 10.0f);
+    emitter.velocityMin = CookieEngine::Vector3(-1.0f, 0.0f, -1.0f);
+    emitter.velocityMax = CookieEngine::Vector3(1.0f, 5.0f, 1.0f);
+    emitter.lifetimeMin = kLifetimeMin;
+    emitter.lifetimeMax = kLifetimeMax;
+    emitter.rate = (float)kParticleCount;
+    uint32_t index = particles.AddEmitter(emitter);
+    
+    // One second at full rate fills the buffer, then the rate only keeps it full
+    particles.Update(1.0f, jobs);
+    particles.GetEmitter(index).rate = kParticleCount * 2.0f / (kLifetimeMin + kLifetimeMax);
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        particles.Update(kStep, jobs);
+    });
+    printf("%s: %u alive, %u wide SIMD\n", name, particles.GetAliveCount(), particles.GetStats().simdWidth);
+    Benchmarks::PrintResult("  Update", seconds, particles.GetAliveCount(), "particles/ms");
+    
+    std::vector<CookieEngine::ParticleVertex> vertices(particles.GetAliveCount());
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        particles.WriteVertices(vertices.data(), (uint32_t)vertices.size(), jobs);
+    });
+    Benchmarks::KeepAlive(vertices[0]);
+    Benchmarks::PrintResult("  WriteVertices", seconds, particles.GetAliveCount(), "particles/ms");
+}
+
+int main() {
+    CookieEngine::JobSystem jobs;
+    Run("One thread", nullptr);
+    Run("Job threads", &jobs);
+    return 0;
+}
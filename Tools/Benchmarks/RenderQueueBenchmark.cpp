@@ -0,0 +1,131 @@
+//
+//  RenderQueueBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Records 100k draws into a RenderQueue and replays them into a MockGraphics and into empty functions
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include -ICookieEngine/Render/include Tools/Benchmarks/RenderQueueBenchmark.cpp
+//         CookieEngine/Render/src/RenderCommandList.cpp CookieEngine/Render/src/RenderQueue.cpp
+//         CookieEngine/Render/src/MockGraphics.cpp CookieEngine/Math/src/*.cpp CookieEngine/Memory/src/*.cpp
+//         CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include <algorithm>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "MockGraphics.h"
+#include "RenderQueue.h"
+#include "Vector3.h"
+
+static const uint32_t kDrawCount = 100000;
+static const uint32_t kGrainSize = 1024;
+static const uint32_t kProgramCount = 8;
+static const uint32_t kVertexArrayCount = 64;
+static const int kRepeatCount = 10;
+
+namespace
+{
+    // Replays into these to measure the queue without any backend cost
+    void NullClear(void*, uint32_t, const float*, float) {}
+    void NullViewport(void*, int32_t, int32_t, int32_t, int32_t) {}
+    void NullUseProgram(void*, uint32_t) {}
+    void NullUniform(void*, int32_t, CookieEngine::UniformType, uint32_t, const void*) {}
+    void NullBindVertexArray(void*, uint32_t) {}
+    void NullBindTexture(void*, uint32_t, uint32_t) {}
+    void NullBindUniformBuffer(void*, uint32_t, uint32_t) {}
+    void NullDrawArrays(void*, CookieEngine::PrimitiveType, uint32_t, uint32_t, uint32_t) {}
+    void NullDrawElements(void*, CookieEngine::PrimitiveType, CookieEngine::IndexType, uint32_t, uint32_t, uint32_t) {}
+    
+    CookieEngine::GraphicsFunctions GetNullFunctions()
+    {
+        CookieEngine::GraphicsFunctions functions;
+        functions.context = nullptr;
+        functions.clear = NullClear;
+        functions.viewport = NullViewport;
+        functions.useProgram = NullUseProgram;
+        functions.uniform = NullUniform;
+        functions.bindVertexArray = NullBindVertexArray;
+        functions.bindTexture = NullBindTexture;
+        functions.bindUniformBuffer = NullBindUniformBuffer;
+        functions.drawArrays = NullDrawArrays;
+        functions.drawElements = NullDrawElements;
+        return functions;
+    }
+} // namespace
+
+int main() {
+    // Draws come sorted by program, then by mesh, like a sorted render list
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> transforms(kDrawCount);
+    std::vector<uint32_t> programs(kDrawCount);
+    std::vector<uint32_t> vertexArrays(kDrawCount);
+    for(uint32_t i = 0; i < kDrawCount; i++)
+    {
+        transforms[i].CreateTranslation(CookieEngine::Vector3((float)i, 0.0f, 0.0f));
+        programs[i] = 1 + i * kProgramCount / kDrawCount;
+        vertexArrays[i] = 1 + i * kVertexArrayCount / kDrawCount;
+    }
+    
+    const CookieEngine::Matrix4* transformData = transforms.data();
+    const uint32_t* programData = programs.data();
+    const uint32_t* vertexArrayData = vertexArrays.data();
+    CookieEngine::RenderQueue::RecordFunction record = [=](CookieEngine::RenderCommandList& list, uint32_t begin, uint32_t end)
+    {
+        for(uint32_t i = begin; i < end; i++)
+        {
+            list.UseProgram(programData[i]);
+            list.SetUniform(0, transformData[i]);
+            list.BindVertexArray(vertexArrayData[i]);
+            list.DrawIndexed(CookieEngine::PrimitiveType::Triangles, CookieEngine::IndexType::UInt16, 0, 36);
+        }
+    };
+    
+    CookieEngine::JobSystem jobs;
+    CookieEngine::RenderQueue queue;
+    printf("%u job threads\n", jobs.GetThreadCount());
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        queue.Record(kDrawCount, kGrainSize, record, nullptr);
+        queue.Reset();
+    });
+    Benchmarks::PrintResult("Record, calling thread", seconds, kDrawCount, "draws/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        queue.Record(kDrawCount, kGrainSize, record, &jobs);
+        queue.Reset();
+    });
+    Benchmarks::PrintResult("Record, jobs", seconds, kDrawCount, "draws/ms");
+    
+    // Only Submit is timed, every run replays a freshly recorded queue
+    CookieEngine::GraphicsFunctions nullFunctions = GetNullFunctions();
+    double best = 1e30;
+    for(int i = 0; i < kRepeatCount; i++)
+    {
+        queue.Record(kDrawCount, kGrainSize, record, &jobs);
+        best = std::min(best, Benchmarks::MeasureBest(1, [&] { queue.Submit(nullFunctions); }));
+    }
+    Benchmarks::PrintResult("Replay, empty functions", best, kDrawCount, "draws/ms");
+    
+    const CookieEngine::RenderQueueStats& stats = queue.GetStats();
+    printf("%u lists, %u commands, %u binds skipped, %.1f bytes per draw\n", stats.listCount, stats.commandCount,
+           stats.skippedCount, (double)stats.usedBytes / kDrawCount);
+    
+    CookieEngine::MockGraphics mock;
+    CookieEngine::GraphicsFunctions mockFunctions = mock.GetFunctions();
+    best = 1e30;
+    for(int i = 0; i < kRepeatCount; i++)
+    {
+        queue.Record(kDrawCount, kGrainSize, record, &jobs);
+        mock.Reset();
+        best = std::min(best, Benchmarks::MeasureBest(1, [&] { queue.Submit(mockFunctions); }));
+    }
+    Benchmarks::PrintResult("Replay, MockGraphics", best, kDrawCount, "draws/ms");
+    
+    return 0;
+}
@@ -0,0 +1,94 @@
+//
+//  SkinningBenchmark.cpp
+//  Benchmarks
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Measures skinning palette throughput in bones/ms and CPU skinning in vertices/ms
+//  build: g++ -std=c++11 -O2 -msse4.1 -ICookieEngine/include -ICookieEngine/Math/include
+//         -ICookieEngine/Memory/include -ICookieEngine/Animation/include Tools/Benchmarks/SkinningBenchmark.cpp
+//         CookieEngine/Animation/src/*.cpp CookieEngine/Math/src/*.cpp CookieEngine/Memory/src/*.cpp
+//         CookieEngine/src/JobSystem.cpp -lpthread
+//
+
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "Skeleton.h"
+#include "Skinning.h"
+
+static const uint32_t kJointCount = 64;
+static const uint32_t kInstanceCount = 1000;
+static const uint32_t kVertexCount = 100000;
+static const int kRepeatCount = 10;
+
+int main() {
+    // A branching skeleton, every joint hangs off the one 4 before it
+    CookieEngine::Skeleton skeleton;
+    for(uint32_t i = 0; i < kJointCount; i++)
+    {
+        CookieEngine::Matrix4 bind;
+        bind.CreateTranslation(CookieEngine::Vector3(0.0f, 0.1f, 0.0f));
+        skeleton.AddJoint("joint", i < 4 ? CookieEngine::Skeleton::kNoParent : (int)i - 4, bind);
+    }
+    skeleton.ComputeInverseBindPose();
+    
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> locals(kJointCount * kInstanceCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> models(kJointCount * kInstanceCount);
+    CookieEngine::AlignedVector<CookieEngine::Matrix4> palettes(kJointCount * kInstanceCount);
+    for(size_t i = 0; i < locals.size(); i++)
+    {
+        locals[i].CreateRotationZ((float)(i % 17) * 0.05f);
+    }
+    
+    CookieEngine::VertexStreams in;
+    CookieEngine::VertexStreams out;
+    in.Resize(kVertexCount);
+    out.Resize(kVertexCount);
+    std::vector<CookieEngine::SkinWeights> weights(kVertexCount);
+    for(uint32_t i = 0; i < kVertexCount; i++)
+    {
+        in.positionX[i] = (float)(i % 100) * 0.01f;
+        in.positionY[i] = (float)(i % 37) * 0.02f;
+        in.positionZ[i] = 0.0f;
+        in.normalX[i] = 0.0f;
+        in.normalY[i] = 0.0f;
+        in.normalZ[i] = 1.0f;
+        for(uint32_t j = 0; j < CookieEngine::kMaxJointInfluences; j++)
+        {
+            weights[i].joints[j] = (uint16_t)((i + j * 5) % kJointCount);
+            weights[i].weights[j] = 0.25f;
+        }
+    }
+    
+    CookieEngine::JobSystem jobs;
+    printf("%u joints x %u instances, %u vertices, %u job threads\n", kJointCount, kInstanceCount, kVertexCount,
+           jobs.GetThreadCount());
+    
+    double seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        skeleton.ComputeSkinningPalettes(kInstanceCount, locals.data(), models.data(), palettes.data(), nullptr);
+    });
+    Benchmarks::KeepAlive(palettes[0]);
+    Benchmarks::PrintResult("Palettes, one thread", seconds, kJointCount * kInstanceCount, "bones/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        skeleton.ComputeSkinningPalettes(kInstanceCount, locals.data(), models.data(), palettes.data(), &jobs);
+    });
+    Benchmarks::PrintResult("Palettes, job threads", seconds, kJointCount * kInstanceCount, "bones/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        CookieEngine::SkinVertices(palettes.data(), in, weights.data(), out, 0, kVertexCount);
+    });
+    Benchmarks::KeepAlive(out.positionX[0]);
+    Benchmarks::PrintResult("Linear blend skinning, one thread", seconds, kVertexCount, "vertices/ms");
+    
+    seconds = Benchmarks::MeasureBest(kRepeatCount, [&]
+    {
+        CookieEngine::SkinVertices(palettes.data(), in, weights.data(), out, jobs);
+    });
+    Benchmarks::PrintResult("Linear blend skinning, job threads", seconds, kVertexCount, "vertices/ms");
+    
+    return 0;
+}
@@ -0,0 +1,518 @@
+//
+//  GltfImporter.cpp
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "GltfImporter.h"
+#include "Json.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace MeshConverter
+{
+
+using namespace CookieEngine;
+
+namespace
+{
+    const uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+    const uint32_t kGlbJsonChunk = 0x4E4F534A;  // "JSON"
+    const uint32_t kGlbBinChunk = 0x004E4942;   // "BIN\0"
+    
+    const int kComponentUnsignedByte = 5121;
+    const int kComponentUnsignedShort = 5123;
+    const int kComponentUnsignedInt = 5125;
+    const int kComponentFloat = 5126;
+    
+    const int kModeTriangles = 4;
+    
+    typedef std::vector<uint8_t> Buffer;
+    
+    bool ReadFile(const std::string& filename, Buffer& out)
+    {
+        std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+        if(!file.is_open())
+        {
+            return false;
+        }
+        out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+    
+    std::string DirectoryOf(const std::string& filename)
+    {
+        size_t slash = filename.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : filename.substr(0, slash + 1);
+    }
+    
+    bool DecodeBase64(const std::string& text, size_t start, Buffer& out)
+    {
+        static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        
+        uint32_t bits = 0;
+        int bitCount = 0;
+        for(size_t i = start; i < text.size() && text[i] != '='; i++)
+        {
+            const char* digit = strchr(alphabet, text[i]);
+            if(!digit || text[i] == '\0')
+            {
+                return false;
+            }
+            bits = (bits << 6) | (uint32_t)(digit - alphabet);
+            bitCount += 6;
+            if(bitCount >= 8)
+            {
+                bitCount -= 8;
+                out.push_back((uint8_t)(bits >> bitCount));
+            }
+        }
+        return true;
+    }
+    
+    bool LoadBuffers(const JsonValue& document, const std::string& directory, const Buffer* glbBinary,
+                     std::vector<Buffer>& buffers, std::string& error)
+    {
+        const JsonValue* list = document.Find("buffers");
+        if(!list || !list->IsArray())
+        {
+            error = "glTF has no buffers";
+            return false;
+        }
+        
+        buffers.resize(list->array.size());
+        for(size_t i = 0; i < list->array.size(); i++)
+        {
+            const JsonValue* uri = list->array[i].Find("uri");
+            if(!uri)
+            {
+                if(i != 0 || !glbBinary)
+                {
+                    error = "glTF buffer without uri";
+                    return false;
+                }
+                buffers[i] = *glbBinary;
+                continue;
+            }
+            
+            const std::string& path = uri->string;
+            if(path.compare(0, 5, "data:") == 0)
+            {
+                size_t comma = path.find(";base64,");
+                if(comma == std::string::npos || !DecodeBase64(path, comma + 8, buffers[i]))
+                {
+                    error = "Unsupported glTF data uri";
+                    return false;
+                }
+            }
+            else if(!ReadFile(directory + path, buffers[i]))
+            {
+                error = "Failed to open glTF buffer: " + directory + path;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    int ComponentCount(const std::string& type)
+    {
+        if(type == "SCALAR") return 1;
+        if(type == "VEC2") return 2;
+        if(type == "VEC3") return 3;
+        if(type == "VEC4") return 4;
+        return 0;
+    }
+    
+    int ComponentSize(int componentType)
+    {
+        switch(componentType)
+        {
+            case kComponentUnsignedByte: return 1;
+            case kComponentUnsignedShort: return 2;
+            case kComponentUnsignedInt: return 4;
+            case kComponentFloat: return 4;
+            default: return 0;
+        }
+    }
+    
+    // Resolves accessor index to its first element, element stride and count
+    bool LocateAccessor(const JsonValue& document, const std::vector<Buffer>& buffers, int index,
+                        const JsonValue*& accessor, const uint8_t*& data, size_t& stride, size_t& count,
+                        std::string& error)
+    {
+        const JsonValue* accessors = document.Find("accessors");
+        const JsonValue* views = document.Find("bufferViews");
+        if(!accessors || !views || index < 0 || index >= (int)accessors->array.size())
+        {
+            error = "Invalid glTF accessor";
+            return false;
+        }
+        
+        accessor = &accessors->array[index];
+        int viewIndex = (int)accessor->GetNumber("bufferView", -1);
+        if(viewIndex < 0 || viewIndex >= (int)views->array.size())
+        {
+            error = "Sparse or empty glTF accessors are not supported";
+            return false;
+        }
+        
+        const JsonValue& view = views->array[viewIndex];
+        int bufferIndex = (int)view.GetNumber("buffer", -1);
+        if(bufferIndex < 0 || bufferIndex >= (int)buffers.size())
+        {
+            error = "Invalid glTF buffer view";
+            return false;
+        }
+        
+        const JsonValue* type = accessor->Find("type");
+        int componentType = (int)accessor->GetNumber("componentType", 0);
+        size_t elementSize = (size_t)ComponentSize(componentType) * ComponentCount(type ? type->string : "");
+        if(elementSize == 0)
+        {
+            error = "Unsupported glTF accessor type";
+            return false;
+        }
+        
+        size_t offset = (size_t)view.GetNumber("byteOffset", 0) + (size_t)accessor->GetNumber("byteOffset", 0);
+        stride = (size_t)view.GetNumber("byteStride", 0);
+        if(stride == 0)
+        {
+            stride = elementSize;
+        }
+        count = (size_t)accessor->GetNumber("count", 0);
+        
+        const Buffer& buffer = buffers[bufferIndex];
+        if(count > 0 && offset + (count - 1) * stride + elementSize > buffer.size())
+        {
+            error = "glTF accessor out of buffer range";
+            return false;
+        }
+        
+        data = buffer.data() + offset;
+        return true;
+    }
+    
+    bool ReadFloats(const JsonValue& document, const std::vector<Buffer>& buffers, int index, int components,
+                    std::vector<float>& out, std::string& error)
+    {
+        const JsonValue* accessor;
+        const uint8_t* data;
+        size_t stride, count;
+        if(!LocateAccessor(document, buffers, index, accessor, data, stride, count, error))
+        {
+            return false;
+        }
+        
+        const JsonValue* type = accessor->Find("type");
+        if(accessor->GetNumber("componentType", 0) != kComponentFloat || ComponentCount(type->string) != components)
+        {
+            error = "Only float glTF vertex attributes are supported";
+            return false;
+        }
+        
+        out.resize(count * components);
+        for(size_t i = 0; i < count; i++)
+        {
+            memcpy(&out[i * components], data + i * stride, components * sizeof(float));
+        }
+        return true;
+    }
+    
+    // Reads a VEC4 accessor of unsigned bytes, shorts or floats as floats. Used for
+    // JOINTS_0, whose indices are stored exactly, and WEIGHTS_0, which may be normalized.
+    bool ReadSkinFloats(const JsonValue& document, const std::vector<Buffer>& buffers, int index,
+                        std::vector<float>& out, std::string& error)
+    {
+        const JsonValue* accessor;
+        const uint8_t* data;
+        size_t stride, count;
+        if(!LocateAccessor(document, buffers, index, accessor, data, stride, count, error))
+        {
+            return false;
+        }
+        
+        const JsonValue* type = accessor->Find("type");
+        if(ComponentCount(type->string) != 4)
+        {
+            error = "glTF skin attributes must be VEC4";
+            return false;
+        }
+        
+        int componentType = (int)accessor->GetNumber("componentType", 0);
+        const JsonValue* normalizedValue = accessor->Find("normalized");
+        bool normalized = normalizedValue && normalizedValue->boolean;
+        
+        out.resize(count * 4);
+        for(size_t i = 0; i < count; i++)
+        {
+            const uint8_t* element = data + i * stride;
+            for(int c = 0; c < 4; c++)
+            {
+                float& value = out[i * 4 + c];
+                switch(componentType)
+                {
+                    case kComponentUnsignedByte:
+                        value = normalized ? element[c] / 255.0f : (float)element[c];
+                        break;
+                    case kComponentUnsignedShort:
+                    {
+                        uint16_t component;
+                        memcpy(&component, element + c * sizeof(component), sizeof(component));
+                        value = normalized ? component / 65535.0f : (float)component;
+                        break;
+                    }
+                    case kComponentFloat:
+                        memcpy(&value, element + c * sizeof(float), sizeof(float));
+                        break;
+                    default:
+                        error = "Invalid glTF skin attribute type";
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    bool ReadIndices(const JsonValue& document, const std::vector<Buffer>& buffers, int index,
+                     std::vector<uint32_t>& out, std::string& error)
+    {
+        const JsonValue* accessor;
+        const uint8_t* data;
+        size_t stride, count;
+        if(!LocateAccessor(document, buffers, index, accessor, data, stride, count, error))
+        {
+            return false;
+        }
+        
+        int componentType = (int)accessor->GetNumber("componentType", 0);
+        out.resize(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            const uint8_t* element = data + i * stride;
+            switch(componentType)
+            {
+                case kComponentUnsignedByte:
+                    out[i] = *element;
+                    break;
+                case kComponentUnsignedShort:
+                {
+                    uint16_t value;
+                    memcpy(&value, element, sizeof(value));
+                    out[i] = value;
+                    break;
+                }
+                case kComponentUnsignedInt:
+                    memcpy(&out[i], element, sizeof(uint32_t));
+                    break;
+                default:
+                    error = "Invalid glTF index type";
+                    return false;
+            }
+        }
+        return true;
+    }
+    
+    bool SplitGlb(const Buffer& file, std::string& json, Buffer& binary, std::string& error)
+    {
+        uint32_t header[3];
+        if(file.size() < sizeof(header))
+        {
+            error = "Truncated glb file";
+            return false;
+        }
+        memcpy(header, file.data(), sizeof(header));
+        if(header[0] != kGlbMagic || header[1] != 2)
+        {
+            error = "Not a glTF 2.0 binary file";
+            return false;
+        }
+        
+        size_t offset = sizeof(header);
+        while(offset + 8 <= file.size())
+        {
+            uint32_t chunk[2];
+            memcpy(chunk, file.data() + offset, sizeof(chunk));
+            offset += sizeof(chunk);
+            if(offset + chunk[0] > file.size())
+            {
+                error = "Truncated glb chunk";
+                return false;
+            }
+            
+            const char* begin = reinterpret_cast<const char*>(file.data() + offset);
+            if(chunk[1] == kGlbJsonChunk)
+            {
+                json.assign(begin, chunk[0]);
+            }
+            else if(chunk[1] == kGlbBinChunk)
+            {
+                binary.assign(file.data() + offset, file.data() + offset + chunk[0]);
+            }
+            offset += chunk[0];
+        }
+        
+        if(json.empty())
+        {
+            error = "glb file has no JSON chunk";
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+bool ImportGltf(const std::string& filename, MeshData& mesh, std::string& error)
+{
+    Buffer file;
+    if(!ReadFile(filename, file))
+    {
+        error = "Failed to open file: " + filename;
+        return false;
+    }
+    
+    std::string json;
+    Buffer glbBinary;
+    bool isGlb = file.size() >= 4 && memcmp(file.data(), "glTF", 4) == 0;
+    if(isGlb)
+    {
+        if(!SplitGlb(file, json, glbBinary, error))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        json.assign(file.begin(), file.end());
+    }
+    
+    JsonValue document;
+    if(!ParseJson(json, document, error))
+    {
+        error = filename + ": " + error;
+        return false;
+    }
+    
+    std::vector<Buffer> buffers;
+    if(!LoadBuffers(document, DirectoryOf(filename), isGlb ? &glbBinary : nullptr, buffers, error))
+    {
+        return false;
+    }
+    
+    // Collect the triangle primitives first so the layout can be chosen up front
+    std::vector<const JsonValue*> primitives;
+    const JsonValue* meshes = document.Find("meshes");
+    for(size_t m = 0; meshes && m < meshes->array.size(); m++)
+    {
+        const JsonValue* list = meshes->array[m].Find("primitives");
+        for(size_t p = 0; list && p < list->array.size(); p++)
+        {
+            const JsonValue& primitive = list->array[p];
+            const JsonValue* attributes = primitive.Find("attributes");
+            if(primitive.GetNumber("mode", kModeTriangles) == kModeTriangles && attributes && attributes->Find("POSITION"))
+            {
+                primitives.push_back(&primitive);
+            }
+        }
+    }
+    
+    if(primitives.empty())
+    {
+        error = "No triangle meshes in " + filename;
+        return false;
+    }
+    
+    bool hasNormals = true;
+    bool hasTexCoords = true;
+    bool hasSkin = true;
+    for(size_t p = 0; p < primitives.size(); p++)
+    {
+        const JsonValue* attributes = primitives[p]->Find("attributes");
+        hasNormals = hasNormals && attributes->Find("NORMAL");
+        hasTexCoords = hasTexCoords && attributes->Find("TEXCOORD_0");
+        hasSkin = hasSkin && attributes->Find("JOINTS_0") && attributes->Find("WEIGHTS_0");
+    }
+    
+    mesh = MeshData();
+    uint32_t positionOffset = mesh.AddAttribute(VertexAttribute::Position, 3);
+    uint32_t normalOffset = hasNormals ? mesh.AddAttribute(VertexAttribute::Normal, 3) : 0;
+    uint32_t texCoordOffset = hasTexCoords ? mesh.AddAttribute(VertexAttribute::TexCoord, 2) : 0;
+    uint32_t jointOffset = hasSkin ? mesh.AddAttribute(VertexAttribute::JointIndices, 4) : 0;
+    uint32_t weightOffset = hasSkin ? mesh.AddAttribute(VertexAttribute::JointWeights, 4) : 0;
+    uint32_t strideFloats = mesh.vertexStride / sizeof(float);
+    
+    for(size_t p = 0; p < primitives.size(); p++)
+    {
+        const JsonValue* attributes = primitives[p]->Find("attributes");
+        std::vector<float> positions, normals, texCoords, joints, weights;
+        
+        if(!ReadFloats(document, buffers, (int)attributes->GetNumber("POSITION", -1), 3, positions, error) ||
+           (hasNormals && !ReadFloats(document, buffers, (int)attributes->GetNumber("NORMAL", -1), 3, normals, error)) ||
+           (hasTexCoords && !ReadFloats(document, buffers, (int)attributes->GetNumber("TEXCOORD_0", -1), 2, texCoords, error)) ||
+           (hasSkin && !ReadSkinFloats(document, buffers, (int)attributes->GetNumber("JOINTS_0", -1), joints, error)) ||
+           (hasSkin && !ReadSkinFloats(document, buffers, (int)attributes->GetNumber("WEIGHTS_0", -1), weights, error)))
+        {
+            return false;
+        }
+        
+        size_t vertexCount = positions.size() / 3;
+        if((hasNormals && normals.size() / 3 != vertexCount) || (hasTexCoords && texCoords.size() / 2 != vertexCount) ||
+           (hasSkin && (joints.size() / 4 != vertexCount || weights.size() / 4 != vertexCount)))
+        {
+            error = "glTF attribute counts do not match";
+            return false;
+        }
+        
+        uint32_t baseVertex = mesh.GetVertexCount();
+        mesh.vertices.resize(mesh.vertices.size() + vertexCount * strideFloats);
+        for(size_t v = 0; v < vertexCount; v++)
+        {
+            float* out = &mesh.vertices[(baseVertex + v) * strideFloats];
+            memcpy(out + positionOffset, &positions[v * 3], 3 * sizeof(float));
+            if(hasNormals)
+            {
+                memcpy(out + normalOffset, &normals[v * 3], 3 * sizeof(float));
+            }
+            if(hasTexCoords)
+            {
+                memcpy(out + texCoordOffset, &texCoords[v * 2], 2 * sizeof(float));
+            }
+            if(hasSkin)
+            {
+                memcpy(out + jointOffset, &joints[v * 4], 4 * sizeof(float));
+                memcpy(out + weightOffset, &weights[v * 4], 4 * sizeof(float));
+            }
+        }
+        
+        std::vector<uint32_t> indices;
+        if(primitives[p]->Find("indices"))
+        {
+            if(!ReadIndices(document, buffers, (int)primitives[p]->GetNumber("indices", -1), indices, error))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            for(uint32_t v = 0; v < (uint32_t)vertexCount; v++)
+            {
+                indices.push_back(v);
+            }
+        }
+        
+        for(size_t i = 0; i < indices.size(); i++)
+        {
+            if(indices[i] >= vertexCount)
+            {
+                error = "glTF index out of range";
+                return false;
+            }
+            mesh.indices.push_back(baseVertex + indices[i]);
+        }
+    }
+    
+    return true;
+}
+
+} // namespace MeshConverter
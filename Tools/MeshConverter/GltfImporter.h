@@ -0,0 +1,24 @@
+//
+//  GltfImporter.h
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef MeshConverter_GltfImporter_h
+#define MeshConverter_GltfImporter_h
+
+#include "MeshData.h"
+
+namespace MeshConverter
+{
+
+// Reads a glTF 2.0 file (.gltf with external or embedded buffers, or .glb).
+// All triangle primitives of all meshes are merged into one mesh in their
+// local space; node transforms are not applied. POSITION is required,
+// NORMAL and TEXCOORD_0 are kept when every primitive has them.
+bool ImportGltf(const std::string& filename, MeshData& mesh, std::string& error);
+
+} // namespace MeshConverter
+
+#endif
@@ -0,0 +1,259 @@
+//
+//  Json.cpp
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "Json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace MeshConverter
+{
+
+namespace
+{
+    class JsonParser
+    {
+    private:
+        const char* mCursor;
+        const char* mEnd;
+        std::string& mError;
+        
+        void SkipWhitespace()
+        {
+            while(mCursor < mEnd && (*mCursor == ' ' || *mCursor == '\t' || *mCursor == '\n' || *mCursor == '\r'))
+            {
+                mCursor++;
+            }
+        }
+        
+        bool Fail(const char* message)
+        {
+            if(mError.empty())
+            {
+                mError = message;
+            }
+            return false;
+        }
+        
+        bool Expect(const char* literal)
+        {
+            size_t length = strlen(literal);
+            if((size_t)(mEnd - mCursor) < length || strncmp(mCursor, literal, length) != 0)
+            {
+                return Fail("Unexpected token in JSON");
+            }
+            mCursor += length;
+            return true;
+        }
+        
+        bool ParseString(std::string& out)
+        {
+            mCursor++; // opening quote
+            while(mCursor < mEnd && *mCursor != '"')
+            {
+                char c = *mCursor++;
+                if(c != '\\')
+                {
+                    out += c;
+                    continue;
+                }
+                if(mCursor >= mEnd)
+                {
+                    break;
+                }
+                
+                char escape = *mCursor++;
+                switch(escape)
+                {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                    {
+                        // Only used for names in glTF, keep ASCII and drop the rest
+                        if(mEnd - mCursor < 4)
+                        {
+                            return Fail("Bad unicode escape in JSON");
+                        }
+                        long code = strtol(std::string(mCursor, 4).c_str(), nullptr, 16);
+                        out += code < 0x80 ? (char)code : '?';
+                        mCursor += 4;
+                        break;
+                    }
+                    default: out += escape; break;
+                }
+            }
+            
+            if(mCursor >= mEnd)
+            {
+                return Fail("Unterminated string in JSON");
+            }
+            mCursor++; // closing quote
+            return true;
+        }
+        
+    public:
+        JsonParser(const std::string& text, std::string& error)
+            : mCursor(text.c_str()), mEnd(text.c_str() + text.size()), mError(error)
+        {
+        }
+        
+        bool AtEnd()
+        {
+            SkipWhitespace();
+            return mCursor == mEnd;
+        }
+        
+        bool ParseValue(JsonValue& value, int depth)
+        {
+            if(depth > 64)
+            {
+                return Fail("JSON nested too deeply");
+            }
+            
+            SkipWhitespace();
+            if(mCursor >= mEnd)
+            {
+                return Fail("Unexpected end of JSON");
+            }
+            
+            switch(*mCursor)
+            {
+                case '{':
+                {
+                    value.type = JsonValue::Type::Object;
+                    mCursor++;
+                    SkipWhitespace();
+                    if(mCursor < mEnd && *mCursor == '}')
+                    {
+                        mCursor++;
+                        return true;
+                    }
+                    for(;;)
+                    {
+                        SkipWhitespace();
+                        if(mCursor >= mEnd || *mCursor != '"')
+                        {
+                            return Fail("Expected member name in JSON");
+                        }
+                        
+                        std::pair<std::string, JsonValue> member;
+                        if(!ParseString(member.first))
+                        {
+                            return false;
+                        }
+                        SkipWhitespace();
+                        if(!Expect(":") || !ParseValue(member.second, depth + 1))
+                        {
+                            return false;
+                        }
+                        value.members.push_back(member);
+                        
+                        SkipWhitespace();
+                        if(mCursor < mEnd && *mCursor == ',')
+                        {
+                            mCursor++;
+                            continue;
+                        }
+                        return Expect("}");
+                    }
+                }
+                case '[':
+                {
+                    value.type = JsonValue::Type::Array;
+                    mCursor++;
+                    SkipWhitespace();
+                    if(mCursor < mEnd && *mCursor == ']')
+                    {
+                        mCursor++;
+                        return true;
+                    }
+                    for(;;)
+                    {
+                        value.array.push_back(JsonValue());
+                        if(!ParseValue(value.array.back(), depth + 1))
+                        {
+                            return false;
+                        }
+                        
+                        SkipWhitespace();
+                        if(mCursor < mEnd && *mCursor == ',')
+                        {
+                            mCursor++;
+                            continue;
+                        }
+                        return Expect("]");
+                    }
+                }
+                case '"':
+                    value.type = JsonValue::Type::String;
+                    return ParseString(value.string);
+                case 't':
+                    value.type = JsonValue::Type::Bool;
+                    value.boolean = true;
+                    return Expect("true");
+                case 'f':
+                    value.type = JsonValue::Type::Bool;
+                    value.boolean = false;
+                    return Expect("false");
+                case 'n':
+                    value.type = JsonValue::Type::Null;
+                    return Expect("null");
+                default:
+                {
+                    char* end = nullptr;
+                    value.type = JsonValue::Type::Number;
+                    value.number = strtod(mCursor, &end);
+                    if(end == mCursor)
+                    {
+                        return Fail("Unexpected character in JSON");
+                    }
+                    mCursor = end;
+                    return true;
+                }
+            }
+        }
+    };
+} // namespace
+
+const JsonValue* JsonValue::Find(const char* key) const
+{
+    for(size_t i = 0; i < members.size(); i++)
+    {
+        if(members[i].first == key)
+        {
+            return &members[i].second;
+        }
+    }
+    return nullptr;
+}
+
+double JsonValue::GetNumber(const char* key, double fallback) const
+{
+    const JsonValue* value = Find(key);
+    return (value && value->type == Type::Number) ? value->number : fallback;
+}
+
+bool ParseJson(const std::string& text, JsonValue& root, std::string& error)
+{
+    error.clear();
+    JsonParser parser(text, error);
+    if(!parser.ParseValue(root, 0))
+    {
+        return false;
+    }
+    if(!parser.AtEnd())
+    {
+        error = "Trailing characters after JSON";
+        return false;
+    }
+    return true;
+}
+
+} // namespace MeshConverter
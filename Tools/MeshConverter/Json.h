@@ -0,0 +1,56 @@
+//
+//  Json.h
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef MeshConverter_Json_h
+#define MeshConverter_Json_h
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MeshConverter
+{
+
+// Just enough JSON to read glTF documents
+class JsonValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+    
+    Type type;
+    bool boolean;
+    double number;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue> > members;
+    
+    JsonValue() : type(Type::Null), boolean(false), number(0.0), string(), array(), members() {}
+    
+    // Returns the member called key, nullptr if this is not an object or has no such member
+    const JsonValue* Find(const char* key) const;
+    
+    // Returns the number of member key or fallback
+    double GetNumber(const char* key, double fallback) const;
+    
+    bool IsObject() const { return type == Type::Object; }
+    bool IsArray() const { return type == Type::Array; }
+};
+
+// Parses text into root, returns false and fills error on malformed input
+bool ParseJson(const std::string& text, JsonValue& root, std::string& error);
+
+} // namespace MeshConverter
+
+#endif
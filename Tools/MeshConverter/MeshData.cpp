@@ -0,0 +1,128 @@
+//
+//  MeshData.cpp
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "MeshData.h"
+
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+
+namespace MeshConverter
+{
+
+using namespace CookieEngine;
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t MeshData::AddAttribute(VertexAttribute attribute, uint32_t components)
+{
+    VertexAttributeDesc desc;
+    desc.attribute = attribute;
+    desc.components = components;
+    desc.offset = vertexStride;
+    desc.reserved = 0;
+    attributes.push_back(desc);
+    
+    vertexStride += components * sizeof(float);
+    return desc.offset / sizeof(float);
+}
+
+bool WriteMeshFile(const std::string& filename, const MeshData& mesh, std::string& error)
+{
+    if(mesh.attributes.empty() || mesh.attributes.size() > kMaxVertexAttributes)
+    {
+        error = "Unsupported vertex layout";
+        return false;
+    }
+    
+    uint32_t vertexCount = mesh.GetVertexCount();
+    bool shortIndices = vertexCount <= 0x10000;
+    
+    MeshFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kMeshMagic;
+    header.version = kMeshVersion;
+    header.vertexCount = vertexCount;
+    header.indexCount = (uint32_t)mesh.indices.size();
+    header.vertexStride = mesh.vertexStride;
+    header.indexSize = shortIndices ? 2 : 4;
+    header.attributeCount = (uint32_t)mesh.attributes.size();
+    header.vertexOffset = AlignUp(sizeof(MeshFileHeader), kMeshBlobAlignment);
+    header.vertexBytes = (uint64_t)vertexCount * mesh.vertexStride;
+    header.indexOffset = AlignUp(header.vertexOffset + header.vertexBytes, kMeshBlobAlignment);
+    header.indexBytes = (uint64_t)header.indexCount * header.indexSize;
+    
+    for(size_t i = 0; i < mesh.attributes.size(); i++)
+    {
+        header.attributes[i] = mesh.attributes[i];
+    }
+    
+    // Bounds come from the position attribute
+    for(int c = 0; c < 3; c++)
+    {
+        header.boundsMin[c] = vertexCount ? FLT_MAX : 0.0f;
+        header.boundsMax[c] = vertexCount ? -FLT_MAX : 0.0f;
+    }
+    header.boundsMin[3] = 1.0f;
+    header.boundsMax[3] = 1.0f;
+    
+    for(size_t a = 0; a < mesh.attributes.size(); a++)
+    {
+        if(mesh.attributes[a].attribute != VertexAttribute::Position)
+        {
+            continue;
+        }
+        
+        uint32_t strideFloats = mesh.vertexStride / sizeof(float);
+        uint32_t offset = mesh.attributes[a].offset / sizeof(float);
+        for(uint32_t v = 0; v < vertexCount; v++)
+        {
+            const float* position = &mesh.vertices[v * strideFloats + offset];
+            for(int c = 0; c < 3; c++)
+            {
+                header.boundsMin[c] = position[c] < header.boundsMin[c] ? position[c] : header.boundsMin[c];
+                header.boundsMax[c] = position[c] > header.boundsMax[c] ? position[c] : header.boundsMax[c];
+            }
+        }
+    }
+    
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        error = "Failed to open output file: " + filename;
+        return false;
+    }
+    
+    static const char padding[kMeshBlobAlignment] = {};
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, (std::streamsize)(header.vertexOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(mesh.vertices.data()), (std::streamsize)header.vertexBytes);
+    file.write(padding, (std::streamsize)(header.indexOffset - header.vertexOffset - header.vertexBytes));
+    
+    if(shortIndices)
+    {
+        std::vector<uint16_t> shorts(mesh.indices.begin(), mesh.indices.end());
+        file.write(reinterpret_cast<const char*>(shorts.data()), (std::streamsize)header.indexBytes);
+    }
+    else
+    {
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), (std::streamsize)header.indexBytes);
+    }
+    
+    if(!file.good())
+    {
+        error = "Failed to write output file: " + filename;
+        return false;
+    }
+    return true;
+}
+
+} // namespace MeshConverter
@@ -0,0 +1,40 @@
+//
+//  MeshData.h
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef MeshConverter_MeshData_h
+#define MeshConverter_MeshData_h
+
+#include "MeshFormat.h"
+
+#include <string>
+#include <vector>
+
+namespace MeshConverter
+{
+
+// Mesh in the interleaved layout it will have on disk
+struct MeshData
+{
+    std::vector<CookieEngine::VertexAttributeDesc> attributes;
+    uint32_t vertexStride;      // in bytes
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    
+    MeshData() : attributes(), vertexStride(0), vertices(), indices() {}
+    
+    // Appends an attribute to the layout and returns its float offset in a vertex
+    uint32_t AddAttribute(CookieEngine::VertexAttribute attribute, uint32_t components);
+    
+    uint32_t GetVertexCount() const { return vertexStride ? (uint32_t)(vertices.size() * sizeof(float) / vertexStride) : 0; }
+};
+
+// Writes mesh as a .cmesh file, returns false and fills error on failure
+bool WriteMeshFile(const std::string& filename, const MeshData& mesh, std::string& error);
+
+} // namespace MeshConverter
+
+#endif
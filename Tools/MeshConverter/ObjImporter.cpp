@@ -0,0 +1,219 @@
+//
+//  ObjImporter.cpp
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#include "ObjImporter.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace MeshConverter
+{
+
+using namespace CookieEngine;
+
+namespace
+{
+    struct ObjIndex
+    {
+        int position;
+        int texCoord;
+        int normal;
+    };
+    
+    struct ObjIndexHash
+    {
+        size_t operator()(const ObjIndex& index) const
+        {
+            return ((size_t)index.position * 73856093u) ^ ((size_t)index.texCoord * 19349663u) ^ ((size_t)index.normal * 83492791u);
+        }
+    };
+    
+    struct ObjIndexEqual
+    {
+        bool operator()(const ObjIndex& lhs, const ObjIndex& rhs) const
+        {
+            return lhs.position == rhs.position && lhs.texCoord == rhs.texCoord && lhs.normal == rhs.normal;
+        }
+    };
+    
+    // Resolves a 1-based or negative (relative) OBJ index, -1 if missing
+    int ResolveIndex(const char* text, size_t count)
+    {
+        if(*text == '\0')
+        {
+            return -1;
+        }
+        int value = atoi(text);
+        if(value < 0)
+        {
+            return (int)count + value;
+        }
+        return value - 1;
+    }
+    
+    bool ParseFaceVertex(const std::string& token, size_t positions, size_t texCoords, size_t normals, ObjIndex& index)
+    {
+        std::string parts[3];
+        int part = 0;
+        for(size_t i = 0; i < token.size() && part < 3; i++)
+        {
+            if(token[i] == '/')
+            {
+                part++;
+            }
+            else
+            {
+                parts[part] += token[i];
+            }
+        }
+        
+        index.position = ResolveIndex(parts[0].c_str(), positions);
+        index.texCoord = ResolveIndex(parts[1].c_str(), texCoords);
+        index.normal = ResolveIndex(parts[2].c_str(), normals);
+        
+        return index.position >= 0 && index.position < (int)positions &&
+               index.texCoord < (int)texCoords && index.normal < (int)normals;
+    }
+} // namespace
+
+bool ImportObj(const std::string& filename, MeshData& mesh, std::string& error)
+{
+    std::ifstream file(filename.c_str(), std::ios::in);
+    if(!file.is_open())
+    {
+        error = "Failed to open file: " + filename;
+        return false;
+    }
+    
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    std::vector<ObjIndex> corners;
+    
+    std::string line;
+    size_t lineNumber = 0;
+    while(std::getline(file, line))
+    {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+        
+        if(keyword == "v")
+        {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            stream >> x >> y >> z;
+            positions.push_back(x);
+            positions.push_back(y);
+            positions.push_back(z);
+        }
+        else if(keyword == "vt")
+        {
+            float u = 0.0f, v = 0.0f;
+            stream >> u >> v;
+            texCoords.push_back(u);
+            texCoords.push_back(v);
+        }
+        else if(keyword == "vn")
+        {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            stream >> x >> y >> z;
+            normals.push_back(x);
+            normals.push_back(y);
+            normals.push_back(z);
+        }
+        else if(keyword == "f")
+        {
+            std::vector<ObjIndex> face;
+            std::string token;
+            while(stream >> token)
+            {
+                ObjIndex index;
+                if(!ParseFaceVertex(token, positions.size() / 3, texCoords.size() / 2, normals.size() / 3, index))
+                {
+                    std::ostringstream message;
+                    message << filename << ":" << lineNumber << ": invalid face index " << token;
+                    error = message.str();
+                    return false;
+                }
+                face.push_back(index);
+            }
+            
+            for(size_t i = 2; i < face.size(); i++)
+            {
+                corners.push_back(face[0]);
+                corners.push_back(face[i - 1]);
+                corners.push_back(face[i]);
+            }
+        }
+    }
+    
+    if(corners.empty())
+    {
+        error = "No faces in " + filename;
+        return false;
+    }
+    
+    // A channel is only written if every corner references it
+    bool hasTexCoords = true;
+    bool hasNormals = true;
+    for(size_t i = 0; i < corners.size(); i++)
+    {
+        hasTexCoords = hasTexCoords && corners[i].texCoord >= 0;
+        hasNormals = hasNormals && corners[i].normal >= 0;
+    }
+    
+    mesh = MeshData();
+    uint32_t positionOffset = mesh.AddAttribute(VertexAttribute::Position, 3);
+    uint32_t normalOffset = hasNormals ? mesh.AddAttribute(VertexAttribute::Normal, 3) : 0;
+    uint32_t texCoordOffset = hasTexCoords ? mesh.AddAttribute(VertexAttribute::TexCoord, 2) : 0;
+    uint32_t strideFloats = mesh.vertexStride / sizeof(float);
+    
+    std::unordered_map<ObjIndex, uint32_t, ObjIndexHash, ObjIndexEqual> welded;
+    mesh.indices.reserve(corners.size());
+    
+    for(size_t i = 0; i < corners.size(); i++)
+    {
+        const ObjIndex& corner = corners[i];
+        std::unordered_map<ObjIndex, uint32_t, ObjIndexHash, ObjIndexEqual>::iterator it = welded.find(corner);
+        if(it != welded.end())
+        {
+            mesh.indices.push_back(it->second);
+            continue;
+        }
+        
+        uint32_t vertex = mesh.GetVertexCount();
+        mesh.vertices.resize(mesh.vertices.size() + strideFloats);
+        float* out = &mesh.vertices[vertex * strideFloats];
+        
+        for(int c = 0; c < 3; c++)
+        {
+            out[positionOffset + c] = positions[corner.position * 3 + c];
+        }
+        if(hasNormals)
+        {
+            for(int c = 0; c < 3; c++)
+            {
+                out[normalOffset + c] = normals[corner.normal * 3 + c];
+            }
+        }
+        if(hasTexCoords)
+        {
+            out[texCoordOffset + 0] = texCoords[corner.texCoord * 2 + 0];
+            out[texCoordOffset + 1] = texCoords[corner.texCoord * 2 + 1];
+        }
+        
+        welded[corner] = vertex;
+        mesh.indices.push_back(vertex);
+    }
+    
+    return true;
+}
+
+} // namespace MeshConverter
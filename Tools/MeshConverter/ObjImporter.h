@@ -0,0 +1,22 @@
+//
+//  ObjImporter.h
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+
+#ifndef MeshConverter_ObjImporter_h
+#define MeshConverter_ObjImporter_h
+
+#include "MeshData.h"
+
+namespace MeshConverter
+{
+
+// Reads positions, texture coordinates, normals and faces of a Wavefront OBJ.
+// Polygons are triangulated as fans and identical v/vt/vn triples are welded.
+bool ImportObj(const std::string& filename, MeshData& mesh, std::string& error);
+
+} // namespace MeshConverter
+
+#endif
@@ -0,0 +1,70 @@
+//
+//  main.cpp
+//  MeshConverter
+//
+//  Copyright (c) 2016 Amos Byon. All rights reserved.
+//
+//  Converts OBJ and glTF meshes to the engine's binary .cmesh format
+//  usage: MeshConverter input.(obj|gltf|glb) output.cmesh
+//
+
+#include <cctype>
+#include <iostream>
+
+#include "GltfImporter.h"
+#include "MeshData.h"
+#include "ObjImporter.h"
+
+static bool EndsWith(const std::string& text, const std::string& suffix)
+{
+    if(text.size() < suffix.size())
+    {
+        return false;
+    }
+    
+    for(size_t i = 0; i < suffix.size(); i++)
+    {
+        if(tolower(text[text.size() - suffix.size() + i]) != suffix[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, const char * argv[]) {
+    if(argc != 3)
+    {
+        std::cout << "usage: " << argv[0] << " input.(obj|gltf|glb) output.cmesh\n";
+        return -1;
+    }
+    
+    std::string input = argv[1];
+    std::string output = argv[2];
+    std::string error;
+    MeshConverter::MeshData mesh;
+    
+    bool imported;
+    if(EndsWith(input, ".obj"))
+    {
+        imported = MeshConverter::ImportObj(input, mesh, error);
+    }
+    else if(EndsWith(input, ".gltf") || EndsWith(input, ".glb"))
+    {
+        imported = MeshConverter::ImportGltf(input, mesh, error);
+    }
+    else
+    {
+        imported = false;
+        error = "Unknown input format: " + input;
+    }
+    
+    if(!imported || !MeshConverter::WriteMeshFile(output, mesh, error))
+    {
+        std::cout << error << "\n";
+        return -1;
+    }
+    
+    std::cout << output << ": " << mesh.GetVertexCount() << " vertices, " << mesh.indices.size() / 3 << " triangles\n";
+    return 0;
+}